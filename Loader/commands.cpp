@@ -7,6 +7,11 @@
 #include "Loader/commands.h"
 #include "obse/CommandTable.h"
 #include "obse/ParamInfos.h"
+#include "Submodule/Trace.h"
+#include "Loader/recorder.h"
+#include "Loader/inventory.h"
+
+#include <vector>
 
 // Include the OBSE version of TESObjectREFR for use in processing arguments
 // We cannot use the COEF version because 
@@ -15,12 +20,23 @@
 // The second issue will be fixed in a future version of OBSE, so we may be 
 // able to use COEF classes here in a limited capacity at some later date.
 #include "obse/GameObjects.h"   
+#include "obse/GameExtraData.h"
 
 /*--------------------------------------------------------------------------------------------*/
 // Ported from CommandTable.cpp so we don't have to include the entire file
 bool Cmd_Default_Execute(COMMAND_ARGS) {return true;} // nop command handler for script editor
 bool Cmd_Default_Eval(COMMAND_ARGS_EVAL) {return true;} // nop command evaluator for script editor
 
+/*--------------------------------------------------------------------------------------------*/
+// Direct dispatch table provided by the submodule, for frequently used commands
+const SubmoduleCommandTable*    g_submoduleCmds = NULL;
+
+// returns true if form is a MyForm, and can be passed directly to the handlers in g_submoduleCmds
+inline bool IsMyForm(TESForm* form)
+{
+    return form && g_submoduleCmds && form->typeID == g_submoduleCmds->myFormType;
+}
+
 /*--------------------------------------------------------------------------------------------*/
 // New script commands for MyForm
 bool Cmd_ListMyForms_Execute(COMMAND_ARGS)
@@ -31,23 +47,34 @@ bool Cmd_ListMyForms_Execute(COMMAND_ARGS)
         and a static variable of the MyForm class.  These are not available in the loader project.
         Therefore, to proceed with this command, execution has to be transferred to the Submodule.
         This is done with the Submodule Interface - see below.
+        Takes no arguments; every MyForm is listed.
     */
+    TraceScope trace("ListMyForms","Command");
+    g_commandRecorder.Record(CommandRecorder::kOpcode_ListMyForms,0,0);
     *result = 0; // initialize result
     g_submoduleInfc->ListMyForms(); // invoke the ListMyForms() method of the submodule interface to hand off execution
     return true;
 }
-DEFINE_COMMAND_PLUGIN(ListMyForms, "Lists all MyForms in the extended data handler", 0, 1, kParams_OneOptionalInventoryObject)
+DEFINE_COMMAND_PLUGIN(ListMyForms, "Lists all MyForms in the extended data handler", 0, 0, NULL)
 bool Cmd_GetMyFormExtraData_Execute(COMMAND_ARGS)
 {
     /*
         Execution function for GetMyFormExtraData
+        If the argument is a MyForm (the common case) it is handed directly to the submodule's
+        dispatch table.  Otherwise it is resolved as a reference, or the calling reference is used.
     */
+    TraceScope trace("GetMyFormExtraData","Command");
     *result = 0; // initialize result
     TESForm* form = 0;  // declare & initialize argument
     g_scriptIntfc->ExtractArgsEx(paramInfo, arg1, opcodeOffsetPtr, scriptObj, eventList, &form);  // extract argument from script environment
-    if (form && (thisObj = OBLIVION_CAST(form,TESForm,TESObjectREFR))) form = 0;   // check if argument is actually a reference
-    if (!form && thisObj) form = thisObj->GetBaseForm(); // if only a reference is provided, use it's base form
-    *result = (SInt32)g_submoduleInfc->GetMyFormExtraData(form); // use interface function to execute command
+    if (!IsMyForm(form))
+    {
+        if (form && (thisObj = OBLIVION_CAST(form,TESForm,TESObjectREFR))) form = 0;   // check if argument is actually a reference
+        if (!form && thisObj) form = thisObj->GetBaseForm(); // if only a reference is provided, use it's base form
+    }
+    g_commandRecorder.Record(CommandRecorder::kOpcode_GetMyFormExtraData,IsMyForm(form) ? form->refID : 0,0);
+    if (IsMyForm(form)) *result = (SInt32)g_submoduleCmds->GetMyFormExtraData(form); // direct dispatch
+    else if (!g_submoduleCmds) *result = (SInt32)g_submoduleInfc->GetMyFormExtraData(form); // no dispatch table, use interface function
     return true;
 }
 DEFINE_COMMAND_PLUGIN(GetMyFormExtraData, "Gets the 'extraData' field of a MyForm object", 0, 1, kParams_OneOptionalInventoryObject)
@@ -56,16 +83,245 @@ bool Cmd_SetMyFormExtraData_Execute(COMMAND_ARGS)
     /*
         Execution function for SetMyFormExtraData
     */
-     *result = 0; // initialize result
+    TraceScope trace("SetMyFormExtraData","Command");
+    *result = 0; // initialize result
     TESForm* form = 0;  // declare & initialize arguments
     UInt32 extraData = 0;
     g_scriptIntfc->ExtractArgsEx(paramInfo, arg1, opcodeOffsetPtr, scriptObj, eventList, &extraData, &form);  // extract args from script environment
-    if (form && (thisObj = OBLIVION_CAST(form,TESForm,TESObjectREFR))) form = 0; // check if argument is actually a reference
-    if (!form && thisObj) form = thisObj->GetBaseForm(); // if only a reference is provided, use it's base form
-    g_submoduleInfc->SetMyFormExtraData(form,extraData); // use interface function to execute command
+    if (!IsMyForm(form))
+    {
+        if (form && (thisObj = OBLIVION_CAST(form,TESForm,TESObjectREFR))) form = 0; // check if argument is actually a reference
+        if (!form && thisObj) form = thisObj->GetBaseForm(); // if only a reference is provided, use it's base form
+    }
+    g_commandRecorder.Record(CommandRecorder::kOpcode_SetMyFormExtraData,IsMyForm(form) ? form->refID : 0,extraData);
+    if (IsMyForm(form)) g_submoduleCmds->SetMyFormExtraData(form,extraData); // direct dispatch
+    else if (!g_submoduleCmds) g_submoduleInfc->SetMyFormExtraData(form,extraData); // no dispatch table, use interface function
     return true;
 }
 DEFINE_COMMAND_PLUGIN(SetMyFormExtraData, "Sets the 'extraData' field of a MyForm object", 0, 2, kParams_OneInt_OneOptionalInventoryObject)
+bool Cmd_CommitMyFormWrites_Execute(COMMAND_ARGS)
+{
+    /*
+        Execution function for CommitMyFormWrites
+        Applies all staged SetMyFormExtraData writes immediately, returns the number of writes applied
+    */
+    TraceScope trace("CommitMyFormWrites","Command");
+    *result = (SInt32)g_submoduleInfc->CommitMyFormWrites();
+    return true;
+}
+DEFINE_COMMAND_PLUGIN(CommitMyFormWrites, "Applies all pending SetMyFormExtraData writes", 0, 0, NULL)
+
+// returns an array of the MyForms with formIDs in [firstFormID, lastFormID], sorted by formID
+bool ReturnMyFormsInRange(UInt32 firstFormID, UInt32 lastFormID, Script* scriptObj, double* result)
+{
+    TESForm* const* forms = NULL;
+    UInt32 count = g_submoduleInfc->GetMyFormsInRange(firstFormID,lastFormID,forms);
+    std::vector<OBSEArrayVarInterface::Element> elements(count);
+    for (UInt32 i = 0; i < count; i++) elements[i] = forms[i];
+    OBSEArrayVarInterface::Array* arr = g_arrayIntfc->CreateArray(count ? &elements[0] : NULL, count, scriptObj);
+    return g_arrayIntfc->AssignCommandResult(arr,result);
+}
+bool Cmd_GetMyFormsInRange_Execute(COMMAND_ARGS)
+{
+    /*
+        Execution function for GetMyFormsInRange
+        Returns an array of all MyForms with formIDs between the two arguments (inclusive)
+    */
+    TraceScope trace("GetMyFormsInRange","Command");
+    *result = 0; // initialize result
+    UInt32 firstFormID = 0, lastFormID = 0;
+    if (!g_scriptIntfc->ExtractArgsEx(paramInfo, arg1, opcodeOffsetPtr, scriptObj, eventList, &firstFormID, &lastFormID)) return true;
+    ReturnMyFormsInRange(firstFormID,lastFormID,scriptObj,result);
+    return true;
+}
+DEFINE_COMMAND_PLUGIN(GetMyFormsInRange, "Returns an array of MyForms with formIDs in the specified range", 0, 2, kParams_TwoInts)
+bool Cmd_GetMyFormsByModIndex_Execute(COMMAND_ARGS)
+{
+    /*
+        Execution function for GetMyFormsByModIndex
+        Returns an array of all MyForms from the specified mod index
+    */
+    TraceScope trace("GetMyFormsByModIndex","Command");
+    *result = 0; // initialize result
+    UInt32 modIndex = 0;
+    if (!g_scriptIntfc->ExtractArgsEx(paramInfo, arg1, opcodeOffsetPtr, scriptObj, eventList, &modIndex) || modIndex > 0xFF) return true;
+    ReturnMyFormsInRange(modIndex << 24, (modIndex << 24) | 0x00FFFFFF, scriptObj, result);
+    return true;
+}
+DEFINE_COMMAND_PLUGIN(GetMyFormsByModIndex, "Returns an array of MyForms from the specified mod index", 0, 1, kParams_OneInt)
+bool Cmd_GetMyFormByEditorID_Execute(COMMAND_ARGS)
+{
+    /*
+        Execution function for GetMyFormByEditorID
+        Returns the MyForm with the specified EditorID (case insensitive), from the submodule's EditorID index
+    */
+    TraceScope trace("GetMyFormByEditorID","Command");
+    *result = 0; // initialize result
+    char editorID[0x200] = {0};
+    if (!g_scriptIntfc->ExtractArgsEx(paramInfo, arg1, opcodeOffsetPtr, scriptObj, eventList, editorID)) return true;
+    TESForm* form = g_submoduleInfc->GetMyFormByEditorID(editorID);
+    if (form) *(UInt32*)result = form->refID; // form results are returned as formIDs
+    return true;
+}
+DEFINE_COMMAND_PLUGIN(GetMyFormByEditorID, "Returns the MyForm with the specified EditorID", 0, 1, kParams_OneString)
+
+// prints a MyFormMemoryUsage report to the output log
+void ReportMyFormMemoryUsage(const MyFormMemoryUsage& usage)
+{
+    _MESSAGE("MyForm Memory Usage: %i forms, %i bytes total", usage.formCount, usage.totalBytes);
+    gLog.Indent();
+    _MESSAGE("objects=%i, strings=%i, list nodes=%i, indexes=%i, allocator overhead=%i (estimated)",
+        usage.objectBytes, usage.stringBytes, usage.listNodeBytes, usage.indexBytes, usage.overheadBytes);
+    gLog.Outdent();
+}
+bool Cmd_GetMyFormMemoryUsage_Execute(COMMAND_ARGS)
+{
+    /*
+        Execution function for GetMyFormMemoryUsage
+        Returns a StringMap of the memory used by all MyForms, in bytes, by component
+    */
+    TraceScope trace("GetMyFormMemoryUsage","Command");
+    *result = 0; // initialize result
+    MyFormMemoryUsage usage;
+    g_submoduleInfc->GetMyFormMemoryUsage(usage);
+    const char* keys[] = { "forms", "objects", "strings", "listNodes", "indexes", "overhead", "total" };
+    OBSEArrayVarInterface::Element values[] = { (double)usage.formCount, (double)usage.objectBytes, (double)usage.stringBytes,
+        (double)usage.listNodeBytes, (double)usage.indexBytes, (double)usage.overheadBytes, (double)usage.totalBytes };
+    OBSEArrayVarInterface::Array* arr = g_arrayIntfc->CreateStringMap(keys, values, sizeof(keys)/sizeof(keys[0]), scriptObj);
+    g_arrayIntfc->AssignCommandResult(arr,result);
+    return true;
+}
+DEFINE_COMMAND_PLUGIN(GetMyFormMemoryUsage, "Returns a StringMap of the memory used by all MyForms, in bytes", 0, 0, NULL)
+
+bool Cmd_DumpMyForms_Execute(COMMAND_ARGS)
+{
+    /*
+        Execution function for DumpMyForms
+        Captures all MyForms and writes them to a CSV file (or JSON, if the argument is nonzero) on a
+        background thread.  Returns 1 if the dump was started, 0 if a previous dump is still running.
+        Use GetMyFormDumpStatus to check for completion.
+    */
+    TraceScope trace("DumpMyForms","Command");
+    *result = 0; // initialize result
+    UInt32 json = 0;
+    if (!g_scriptIntfc->ExtractArgsEx(paramInfo, arg1, opcodeOffsetPtr, scriptObj, eventList, &json)) return true;
+    *result = g_submoduleInfc->DumpMyForms(json != 0) ? 1 : 0;
+    return true;
+}
+DEFINE_COMMAND_PLUGIN(DumpMyForms, "Writes all MyForms to a CSV or JSON file in the background", 0, 1, kParams_OneOptionalInt)
+bool Cmd_GetMyFormDumpStatus_Execute(COMMAND_ARGS)
+{
+    /*
+        Execution function for GetMyFormDumpStatus
+        Returns 0 if no dump was started, 1 if the dump is still being written, 2 if it is complete, -1 if it failed
+    */
+    TraceScope trace("GetMyFormDumpStatus","Command");
+    *result = g_submoduleInfc->MyFormDumpStatus();
+    return true;
+}
+DEFINE_COMMAND_PLUGIN(GetMyFormDumpStatus, "Returns the status of the last DumpMyForms call", 0, 0, NULL)
+
+// collects the MyForm stacks in the inventory of container - base container contents, adjusted by changes
+// made during the game - and returns the number of stacks
+UInt32 CollectMyFormStacks(TESObjectREFR* container, std::vector<TESForm*>& forms, std::vector<SInt32>& counts)
+{
+    std::vector<MyFormStack> entries;
+    TESContainer* baseContainer = OBLIVION_CAST(container->GetBaseForm(),TESForm,TESContainer);
+    if (baseContainer)
+    {
+        for (TESContainer::Entry* entry = &baseContainer->list; entry; entry = entry->next)
+        {
+            if (entry->data && IsMyForm(entry->data->type)) entries.push_back(MyFormStack(entry->data->type,entry->data->count));
+        }
+    }
+    ExtraContainerChanges* changes = (ExtraContainerChanges*)container->baseExtraList.GetByType(kExtraData_ContainerChanges);
+    if (changes && changes->data)
+    {
+        for (ExtraContainerChanges::Entry* entry = changes->data->objList; entry; entry = entry->next)
+        {
+            if (entry->data && IsMyForm(entry->data->type)) entries.push_back(MyFormStack(entry->data->type,entry->data->countDelta));
+        }
+    }
+    return MergeMyFormStacks(entries,forms,counts);    // merge entries for the same form, and drop empty stacks
+}
+bool Cmd_GetMyFormTotals_Execute(COMMAND_ARGS)
+{
+    /*
+        Execution function for GetMyFormTotals
+        Walks the inventory of the reference argument (or the calling reference, if there is no argument)
+        once, and returns a StringMap with the totals over all MyForms it contains: "stacks", "count",
+        "weight", "value", and "extraData" - a Map of item counts by extraData value.
+    */
+    TraceScope trace("GetMyFormTotals","Command");
+    *result = 0; // initialize result
+    TESObjectREFR* container = 0;   // declare & initialize argument
+    if (!g_scriptIntfc->ExtractArgsEx(paramInfo, arg1, opcodeOffsetPtr, scriptObj, eventList, &container)) return true;
+    if (!container) container = thisObj;    // no argument, use the calling reference
+    if (!container || !g_submoduleCmds) return true;
+    std::vector<TESForm*> forms;
+    std::vector<SInt32> counts;
+    UInt32 stacks = CollectMyFormStacks(container,forms,counts);
+    trace.SetArg(stacks);
+
+    MyFormAggregate totals;
+    std::vector<UInt32> histogramKeys(stacks + 1), histogramCounts(stacks + 1);
+    UInt32 histogramSize = 0;
+    g_submoduleInfc->AggregateMyForms(stacks ? &forms[0] : NULL, stacks ? &counts[0] : NULL, stacks, totals,
+        &histogramKeys[0], &histogramCounts[0], histogramSize);
+
+    std::vector<double> keys(histogramSize + 1);
+    std::vector<OBSEArrayVarInterface::Element> values(histogramSize + 1);
+    for (UInt32 i = 0; i < histogramSize; i++) { keys[i] = (SInt32)histogramKeys[i]; values[i] = (double)histogramCounts[i]; }
+    OBSEArrayVarInterface::Array* histogram = g_arrayIntfc->CreateMap(&keys[0], &values[0], histogramSize, scriptObj);
+
+    const char* totalKeys[] = { "stacks", "count", "weight", "value", "extraData" };
+    OBSEArrayVarInterface::Element totalValues[] = { (double)totals.stackCount, (double)totals.itemCount, totals.totalWeight, totals.totalValue, histogram };
+    OBSEArrayVarInterface::Array* arr = g_arrayIntfc->CreateStringMap(totalKeys, totalValues, sizeof(totalKeys)/sizeof(totalKeys[0]), scriptObj);
+    g_arrayIntfc->AssignCommandResult(arr,result);
+    return true;
+}
+DEFINE_COMMAND_PLUGIN(GetMyFormTotals, "Returns a StringMap of totals over all MyForms in a reference's inventory", 0, 1, kParams_OneOptionalObjectRef)
+
+bool Cmd_ReportMyFormConflicts_Execute(COMMAND_ARGS)
+{
+    /*
+        Execution function for ReportMyFormConflicts
+        Writes a report of MyForms overridden by multiple plugins, if conflict detection was enabled during loading.
+        Returns the number of forms with conflicting overrides, or -1 on failure.
+    */
+    TraceScope trace("ReportMyFormConflicts","Command");
+    *result = g_submoduleInfc->ReportMyFormConflicts();
+    return true;
+}
+DEFINE_COMMAND_PLUGIN(ReportMyFormConflicts, "Writes a report of conflicting MyForm overrides", 0, 0, NULL)
+
+// path of the MyForm columnar export file
+#define MYFORM_COLUMNS_PATH "Data\\obse\\plugins\\" SOLUTIONNAME "\\MyForms.columns"
+bool Cmd_ExportMyFormColumns_Execute(COMMAND_ARGS)
+{
+    /*
+        Execution function for ExportMyFormColumns
+        Writes all MyForms to a columnar binary file for external tools (see Submodule/MyFormColumns.h),
+        returns 1 on success
+    */
+    TraceScope trace("ExportMyFormColumns","Command");
+    *result = g_submoduleInfc->ExportMyFormColumns(MYFORM_COLUMNS_PATH) ? 1 : 0;
+    return true;
+}
+DEFINE_COMMAND_PLUGIN(ExportMyFormColumns, "Writes all MyForms to a columnar binary file", 0, 0, NULL)
+
+bool Cmd_ReplayMyFormCommands_Execute(COMMAND_ARGS)
+{
+    /*
+        Execution function for ReplayMyFormCommands
+        Replays the recorded ListMyForms, GetMyFormExtraData & SetMyFormExtraData calls back to back, logs latency
+        percentiles, and restores any extraData values changed by the replay.  Returns the number of calls replayed.
+    */
+    TraceScope trace("ReplayMyFormCommands","Command");
+    *result = ReplayCommandRecording(COMMAND_RECORDING_PATH);
+    return true;
+}
+DEFINE_COMMAND_PLUGIN(ReplayMyFormCommands, "Replays recorded MyForm script commands & reports their latency", 0, 0, NULL)
 
 /*--------------------------------------------------------------------------------------------*/
 // command registration
@@ -76,6 +332,30 @@ void Register_Commands()
     g_obseIntfc->RegisterCommand(&kCommandInfo_ListMyForms); // register test command
     g_obseIntfc->RegisterCommand(&kCommandInfo_GetMyFormExtraData); // register test command
     g_obseIntfc->RegisterCommand(&kCommandInfo_SetMyFormExtraData); // register test command
+    g_obseIntfc->RegisterCommand(&kCommandInfo_CommitMyFormWrites); // register test command
+    g_obseIntfc->RegisterTypedCommand(&kCommandInfo_GetMyFormsInRange, kRetnType_Array); // register test command, returns array
+    g_obseIntfc->RegisterTypedCommand(&kCommandInfo_GetMyFormsByModIndex, kRetnType_Array); // register test command, returns array
+    g_obseIntfc->RegisterTypedCommand(&kCommandInfo_GetMyFormMemoryUsage, kRetnType_Array); // register test command, returns array
+    g_obseIntfc->RegisterTypedCommand(&kCommandInfo_GetMyFormByEditorID, kRetnType_Form); // register test command, returns form
+    g_obseIntfc->RegisterCommand(&kCommandInfo_DumpMyForms); // register test command
+    g_obseIntfc->RegisterCommand(&kCommandInfo_GetMyFormDumpStatus); // register test command
+    g_obseIntfc->RegisterTypedCommand(&kCommandInfo_GetMyFormTotals, kRetnType_Array); // register test command, returns array
+    g_obseIntfc->RegisterCommand(&kCommandInfo_ReportMyFormConflicts); // register test command
+    g_obseIntfc->RegisterCommand(&kCommandInfo_ExportMyFormColumns); // register test command
+    g_obseIntfc->RegisterCommand(&kCommandInfo_ReplayMyFormCommands); // register test command
+    // opcodes are assigned in registration order, and compiled scripts refer to commands by opcode,
+    // so new commands must always be registered last
+}
+
+void Initialize_Commands()
+{// called once the submodule is initialized, which may be after command registration
+    // get direct dispatch table from submodule
+    g_submoduleCmds = g_submoduleInfc ? g_submoduleInfc->CommandTable() : NULL;
+    if (g_submoduleCmds && g_submoduleCmds->version != SubmoduleCommandTable::kVersion)
+    {
+        _ERROR("Submodule command table has wrong version (got %i expected %i)", g_submoduleCmds->version, SubmoduleCommandTable::kVersion);
+        g_submoduleCmds = NULL;
+    }
 }
 
 /*--------------------------------------------------------------------------------------------*/
@@ -84,7 +364,10 @@ void CSEPrintCallback(const char* message, const char* prefix)
 {/* 
     Called whenever output is provided to CSE console, if present
     Commands recognized by this parser take the form 'solutionName commandName [args...]'
+    Output from this plugin is printed with the prefix SOLUTIONNAME, and is ignored - it can be echoed here
+    while the console output target is flushing, and is never a command.
 */
+    if (!message || (prefix && strcmp(prefix,SOLUTIONNAME) == 0)) return; // output from this plugin
     char buffer[0x200];
     strcpy_s(buffer,sizeof(buffer),message);
     char* context = 0;
@@ -103,4 +386,56 @@ void CSEPrintCallback(const char* message, const char* prefix)
     {        
         g_submoduleInfc->ListMyForms();
     }
+    else if (_stricmp(command,"FormStats") == 0)    // 'FormStats' command
+    {
+        g_submoduleInfc->ListFormStatistics();
+    }
+    else if (_stricmp(command,"FlushTrace") == 0)    // 'FlushTrace' command
+    {
+        FlushTrace();
+    }
+    else if (_stricmp(command,"FindEditorID") == 0 && argA)    // 'FindEditorID' command
+    {
+        TESForm* form = g_submoduleInfc->GetMyFormByEditorID(argA);
+        if (form) _MESSAGE("MyForm '%s' is %08X",argA,form->refID);
+        else _MESSAGE("No MyForm with EditorID '%s'",argA);
+    }
+    else if (_stricmp(command,"DumpMyForms") == 0)    // 'DumpMyForms' command, optional arg 'json'
+    {
+        if (!g_submoduleInfc->DumpMyForms(argA && _stricmp(argA,"json") == 0)) _MESSAGE("A MyForm dump is already running");
+    }
+    else if (_stricmp(command,"DumpStatus") == 0)    // 'DumpStatus' command
+    {
+        static const char* statusNames[] = { "failed", "idle", "running", "done" };
+        _MESSAGE("MyForm dump status: %s",statusNames[g_submoduleInfc->MyFormDumpStatus() + 1]);
+    }
+    else if (_stricmp(command,"Conflicts") == 0)    // 'Conflicts' command
+    {
+        g_submoduleInfc->ReportMyFormConflicts();
+    }
+    else if (_stricmp(command,"ExportColumns") == 0)    // 'ExportColumns' command
+    {
+        g_submoduleInfc->ExportMyFormColumns(MYFORM_COLUMNS_PATH);
+    }
+    else if (_stricmp(command,"Replay") == 0)    // 'Replay' command, optional arg is path of recording
+    {
+        ReplayCommandRecording(argA ? argA : COMMAND_RECORDING_PATH);
+    }
+    else if (_stricmp(command,"FlightRecorder") == 0)    // 'FlightRecorder' command
+    {
+        DumpFlightRecorder();
+    }
+    else if (_stricmp(command,"MemoryUsage") == 0)    // 'MemoryUsage' command
+    {
+        MyFormMemoryUsage usage;
+        g_submoduleInfc->GetMyFormMemoryUsage(usage);
+        ReportMyFormMemoryUsage(usage);
+    }
+    else if (_stricmp(command,"CompressMyForms") == 0 && argA)    // 'CompressMyForms' command, arg is name of a saved plugin in Data
+    {
+        char path[MAX_PATH];
+        sprintf_s(path,sizeof(path),"Data\\%s",argA);
+        if (g_submoduleInfc->CompressMyFormRecords(path) < 0) _MESSAGE("Could not compress MyForm records in '%s'",path);
+    }
+    FlushCSEConsole();  // send command output to console immediately
 }
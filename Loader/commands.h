@@ -24,5 +24,17 @@ const int OPCODEBASE        = 0x5000;
 // registers new script commands
 void Register_Commands();
 
+// attaches script commands to the submodule, once it is initialized
+void Initialize_Commands();
+
+// writes activity trace to file, if tracing is enabled
+void FlushTrace();
+
+// sends pending output to the CSE console
+void FlushCSEConsole();
+
+// writes the lines held by the flight recorder to the log file, if it is enabled
+void DumpFlightRecorder();
+
 // parses CSE console commands
 void CSEPrintCallback(const char* Message, const char* Prefix);
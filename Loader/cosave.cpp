@@ -0,0 +1,173 @@
+/*
+    Cosave persistence unit for loader
+*/
+#include "Loader/cosave.h"
+#include "Loader/commands.h"
+#include "Submodule/BulkInterface.h"
+#include "Submodule/Timing.h"
+#include "Submodule/Trace.h"
+
+#include <algorithm>
+
+// local declaration of serialization interface defined in loader.cpp
+extern OBSESerializationInterface* g_serializationIntfc;
+
+/*--------------------------------------------------------------------------------------------*/
+ExtraDataCosave g_extraDataCosave;
+
+ExtraDataCosave::ExtraDataCosave()
+: thread(0), pending(false), valid(false), preloadTicks(0), decodeTicks(0)
+{
+}
+ExtraDataCosave::~ExtraDataCosave()
+{
+    Wait();
+}
+void ExtraDataCosave::Wait()
+{
+    if (!thread) return;
+    WaitForSingleObject(thread,INFINITE);
+    CloseHandle(thread);
+    thread = 0;
+}
+void ExtraDataCosave::Reset()
+{
+    Wait();
+    pending = valid = false;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+void ExtraDataCosave::Save()
+{
+    // the snapshot is current, since staged writes were committed & published before saving
+    const MyFormBulkInterface* bulk = g_submoduleInfc ? g_submoduleInfc->BulkInterface() : NULL;
+    MyFormBulkView view;
+    if (!bulk || !bulk->AcquireView(&view)) return;
+
+    // sort by formID, so loading can apply values in a single merge pass
+    std::vector<std::pair<UInt32,UInt32> > pairs(view.count);
+    for (UInt32 i = 0; i < view.count; i++) pairs[i] = std::make_pair(view.formIDs[i],view.extraData[i]);
+    bulk->ReleaseView(&view);
+    std::sort(pairs.begin(),pairs.end());
+    std::vector<UInt32> columns(pairs.size() * 2);
+    for (UInt32 i = 0; i < pairs.size(); i++)
+    {
+        columns[i] = pairs[i].first;
+        columns[pairs.size() + i] = pairs[i].second;
+    }
+
+    UInt32 count = pairs.size();
+    g_serializationIntfc->OpenRecord(kRecordType,kRecordVersion);
+    g_serializationIntfc->WriteRecordData(&count,sizeof(count));
+    if (count) g_serializationIntfc->WriteRecordData(&columns[0],columns.size() * sizeof(UInt32));
+    _VMESSAGE("Wrote extraData of %i MyForms",count);
+}
+void ExtraDataCosave::Preload()
+{
+    UInt64 start = PerfTicks();
+    Reset(); // a previous load may not have reached LoadCallback
+
+    // read raw record data; only the last 'XDAT' record is kept
+    raw.clear();
+    UInt32 type, version, length;
+    while (g_serializationIntfc->GetNextRecordInfo(&type,&version,&length))
+    {
+        if (type != kRecordType) continue;
+        if (version != kRecordVersion)
+        {
+            _WARNING("Ignoring extraData record with unknown version %i",version);
+            continue;
+        }
+        raw.resize(length);
+        if (length && g_serializationIntfc->ReadRecordData(&raw[0],length) != length)
+        {
+            _ERROR("Could not read extraData record");
+            raw.clear();
+        }
+    }
+
+    // decode on worker thread
+    if (!raw.empty())
+    {
+        pending = true;
+        thread = CreateThread(NULL,0,&DecodeThread,this,0,NULL);
+        if (!thread) Decode(); // fall back to decoding on this thread
+    }
+    preloadTicks = PerfTicks() - start;
+}
+DWORD WINAPI ExtraDataCosave::DecodeThread(LPVOID param)
+{
+    ((ExtraDataCosave*)param)->Decode();
+    return 0;
+}
+void ExtraDataCosave::Decode()
+{
+    // decoding thread - touches only raw, formIDs, extraData & valid, which the game thread doesn't use until Wait()
+    UInt64 start = PerfTicks();
+    valid = false;
+    UInt32 count = (raw.size() >= sizeof(UInt32)) ? *(UInt32*)&raw[0] : 0;
+    if (raw.size() != sizeof(UInt32) + (UInt64)count * 2 * sizeof(UInt32)) count = 0; // malformed
+    else
+    {
+        const UInt32* columns = (const UInt32*)&raw[sizeof(UInt32)];
+        formIDs.assign(columns, columns + count);
+        extraData.assign(columns + count, columns + 2 * count);
+        // records are saved sorted, but verify - order is needed for the merge on apply
+        bool sorted = true;
+        for (UInt32 i = 1; i < count && sorted; i++) sorted = formIDs[i-1] <= formIDs[i];
+        if (!sorted)
+        {
+            std::vector<std::pair<UInt32,UInt32> > pairs(count);
+            for (UInt32 i = 0; i < count; i++) pairs[i] = std::make_pair(formIDs[i],extraData[i]);
+            std::sort(pairs.begin(),pairs.end());
+            for (UInt32 i = 0; i < count; i++) { formIDs[i] = pairs[i].first; extraData[i] = pairs[i].second; }
+        }
+        valid = true;
+    }
+    raw.clear();
+    decodeTicks = PerfTicks() - start;
+}
+void ExtraDataCosave::Apply()
+{
+    UInt64 start = PerfTicks();
+    UInt64 waitStart = start;
+    Wait();
+    UInt64 waitTicks = PerfTicks() - waitStart;
+    if (pending && !valid) _WARNING("Discarded malformed extraData record");
+    bool ready = valid && g_submoduleInfc;
+    pending = valid = false;
+    if (!ready) return;
+    TraceScope trace("ApplyExtraData","Cosave",formIDs.size());
+
+    // remap mod indices for the current load order; forms from mods that are no longer loaded are dropped
+    SInt32 modIndexMap[0x100];
+    for (UInt32 i = 0; i < 0x100; i++) modIndexMap[i] = -2; // not resolved yet
+    UInt32 count = 0;
+    bool sorted = true;
+    for (UInt32 i = 0; i < formIDs.size(); i++)
+    {
+        UInt32 modIndex = formIDs[i] >> 24;
+        if (modIndexMap[modIndex] == -2)
+        {
+            UInt32 resolved = 0;
+            modIndexMap[modIndex] = g_serializationIntfc->ResolveRefID(modIndex << 24,&resolved) ? (SInt32)(resolved >> 24) : -1;
+        }
+        if (modIndexMap[modIndex] < 0) continue;
+        formIDs[count] = (formIDs[i] & 0x00FFFFFF) | (modIndexMap[modIndex] << 24);
+        extraData[count] = extraData[i];
+        if (count && formIDs[count-1] > formIDs[count]) sorted = false;
+        count++;
+    }
+    if (!sorted)
+    {
+        std::vector<std::pair<UInt32,UInt32> > pairs(count);
+        for (UInt32 i = 0; i < count; i++) pairs[i] = std::make_pair(formIDs[i],extraData[i]);
+        std::sort(pairs.begin(),pairs.end());
+        for (UInt32 i = 0; i < count; i++) { formIDs[i] = pairs[i].first; extraData[i] = pairs[i].second; }
+    }
+
+    UInt32 applied = count ? g_submoduleInfc->ApplyMyFormExtraData(&formIDs[0],&extraData[0],count) : 0;
+    _MESSAGE("Applied extraData to %i of %i MyForms from cosave; game thread %.3f ms (preload %.3f, wait %.3f, apply %.3f), decoding thread %.3f ms",
+        applied, formIDs.size(), PerfTicksToMS(preloadTicks + PerfTicks() - start), PerfTicksToMS(preloadTicks),
+        PerfTicksToMS(waitTicks), PerfTicksToMS(PerfTicks() - start - waitTicks), PerfTicksToMS(decodeTicks));
+}
@@ -0,0 +1,50 @@
+/*
+    Cosave persistence of MyForm::extraData for loader
+
+    The extraData of every MyForm is saved in an 'XDAT' cosave record, as a count followed by two columns:
+    sorted formIDs, and the matching extraData values.  Loading is split so that little of it happens on the
+    game thread during the load screen:
+    -   PreloadCallback reads the raw record bytes (the serialization interface may only be used from
+        the thread that invokes the callback), and starts a worker thread to validate and decode them
+    -   by the time LoadCallback runs, the decoded columns are usually ready; LoadCallback waits for the
+        worker if necessary, remaps mod indices for the current load order, and applies the values in
+        a single merge pass over the submodule's sorted formID index
+    Time spent on the game thread (the load critical path) and on the worker is logged for each load.
+*/
+#pragma once
+
+#include <vector>
+
+class ExtraDataCosave
+{
+public:
+    static const UInt32 kRecordType     = 'XDAT';
+    static const UInt32 kRecordVersion  = 1;
+
+    // game thread only, called from cosave callbacks
+    void            Save();     // writes the 'XDAT' record
+    void            Preload();  // reads 'XDAT' records & starts decoding them
+    void            Apply();    // waits for decoding & applies the decoded values
+    void            Reset();    // discards any pending decoded values, e.g. on new game
+
+    // constructor, destructor
+    ExtraDataCosave();
+    ~ExtraDataCosave();
+
+private:
+    void            Wait();     // waits for the decoding thread, if any
+    void            Decode();   // decodes raw into formIDs & extraData, on the decoding thread
+    static DWORD WINAPI DecodeThread(LPVOID param);
+
+    std::vector<UInt8>  raw;        // raw record data
+    std::vector<UInt32> formIDs;    // decoded, sorted
+    std::vector<UInt32> extraData;  // decoded, parallel to formIDs
+    HANDLE              thread;     // decoding thread, or null
+    bool                pending;    // a record was read, and is being decoded
+    bool                valid;      // decoded values are ready to apply
+    UInt64              preloadTicks;   // game thread time spent in Preload()
+    UInt64              decodeTicks;    // decoding thread time, set before thread exits
+};
+
+// global extraData cosave handler
+extern ExtraDataCosave g_extraDataCosave;
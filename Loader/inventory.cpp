@@ -0,0 +1,24 @@
+/*
+    Inventory unit for loader
+*/
+#include "Loader/inventory.h"
+
+#include <algorithm>
+
+/*--------------------------------------------------------------------------------------------*/
+UInt32 MergeMyFormStacks(std::vector<MyFormStack>& entries, std::vector<TESForm*>& forms, std::vector<SInt32>& counts)
+{
+    std::sort(entries.begin(),entries.end());
+    forms.clear();
+    counts.clear();
+    for (UInt32 i = 0; i < entries.size(); )
+    {
+        TESForm* form = entries[i].first;
+        SInt32 count = 0;
+        for (; i < entries.size() && entries[i].first == form; i++) count += entries[i].second;
+        if (count <= 0) continue;   // every item of the base stack was removed
+        forms.push_back(form);
+        counts.push_back(count);
+    }
+    return forms.size();
+}
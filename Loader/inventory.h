@@ -0,0 +1,19 @@
+/*
+    Inventory unit for loader
+    Merges the MyForm stacks of a container, as collected by the GetMyFormTotals command: the counts
+    listed by the base container, and the deltas recorded in its ExtraContainerChanges during the game.
+    Only form pointers are handled here, so this unit does not depend on the OBSE or COEF form classes.
+*/
+#pragma once
+
+#include <vector>
+#include <utility>
+
+class TESForm;
+
+// a stack entry: the base container count, or a change made during the game, for one form
+typedef std::pair<TESForm*,SInt32> MyFormStack;
+
+// sums the entries for each form into forms & counts (sorted by form), dropping forms with no items left,
+// and returns the number of stacks; entries is reordered
+UInt32 MergeMyFormStacks(std::vector<MyFormStack>& entries, std::vector<TESForm*>& forms, std::vector<SInt32>& counts);
@@ -20,13 +20,22 @@
             -   Submodule interface, as laid out in Submodule/Interface.h.  This interface is how the loader communicates
                 with the submodule, to invoke next script commands or react to messages from obse and other plugins.
                 This interface might also be dispatched to other plugins, so that they can invoke the commands directly.
+            -   Bulk data interface, as laid out in Submodule/BulkInterface.h, which is dispatched to other plugins on
+                request so that they can read MyForm data in bulk without per-form calls.
 
 */
 #include "obse/PluginAPI.h"             // for interfacing with obse
 #include "Loader/commands.h"            // defines script & console commands
+#include "Loader/profiler.h"            // startup profiler
+#include "Loader/cosave.h"              // cosave persistence of MyForm data
+#include "Loader/recorder.h"            // script command recorder
+#include "Loader/targets.h"             // custom output targets
+#include "Submodule/Trace.h"            // activity tracing
 #include "Submodule/Version.h"          // version info for this plugin
+#include "Submodule/Settings.h"         // settings file for this plugin
 #include "Submodule/Interface.h"        // for interfacing with the submodule
 #include "Submodule/CSE_Interface.h"    // for interfacing with CSE, if present
+#include "Submodule/BulkInterface.h"    // for interfacing with other plugins
 
 /*--------------------------------------------------------------------------------------------*/
 // global debugging log
@@ -49,36 +58,25 @@ HMODULE                         g_hSubmodule            = 0;    // windows modul
 SubmoduleInterface*             g_submoduleInfc         = NULL; // submodule interface
 CSEInterface*                   g_cseIntfc              = NULL; // CSE master interface, if CSE is present
 CSEConsoleInterface*            g_cseConsoleInfc        = NULL; // CSE console interface
+void                            InitializeSubmodule();  // initializes submodule & gets submodule interface, defined below
 
 /*--------------------------------------------------------------------------------------------*/
-// CSE console output target
-// this is a custom OutputTarget that forwards (plain text) output to the CSE console, if CSE is present 
-class CSEConsoleTarget : public BufferTarget
-{
-public:
-    // interface
-    virtual void    WriteOutputLine(const OutputStyle& style, time_t time, int channel, const char* source, const char* text)
-    {
-        if (!g_cseConsoleInfc || !g_cseConsoleInfc->PrintToConsole) return;  // bad CSE console interface
-        BufferTarget::WriteOutputLine(consoleStyle,time,channel,source,text); // generate output line, without timestamp or source
-        g_cseConsoleInfc->PrintToConsole(SOLUTIONNAME,LastOutputLine());  // write output line to CSE console
-    }
-    // static output style
-    OutputStyle  consoleStyle;
-} _CSETarget;
-
-/*--------------------------------------------------------------------------------------------*/
-// Serialization routines - these are just stubs, to illustrate the basic concept
+// Serialization routines
+// The 'HEAD' record is just a stub, to illustrate the basic concept; MyForm data is persisted in an 'XDAT' record, see cosave.h
 static void SaveCallback(void * reserved)
 {// called during game save by obse to serialize private plugin data to the obse cosave
+    TraceScope trace("SaveCallback","Cosave");
     _MESSAGE("Writing to cosave ...");
+    if (g_submoduleInfc) g_submoduleInfc->CommitMyFormWrites(); // apply staged writes before game state is saved
     g_serializationIntfc->OpenRecord('HEAD',RECORD_VERSION(COSAVE_VERSION));    // open a 'HEAD" record for this plugin
 	const char* desc = g_submoduleInfc ? g_submoduleInfc->Description() : SOLUTIONNAME;  // get a descriptive string for this plugin
 	g_serializationIntfc->WriteRecordData(desc, strlen(desc)); // write description to 'HEAD' record
-    // the 'HEAD' record (which is the only record written by this plugin) is automatically closed at the end of this function
+    g_extraDataCosave.Save(); // write 'XDAT' record, which closes the 'HEAD' record
+    // the last record opened is automatically closed at the end of this function
 }
 static void LoadCallback(void * reserved)
 {// called during game load by obse to deserialize private plugin data from the obse cosave
+    TraceScope trace("LoadCallback","Cosave");
     _MESSAGE("Loading from cosave ...");
     UInt32	type, version, length;
 	char	buf[512];
@@ -88,24 +86,31 @@ static void LoadCallback(void * reserved)
         switch(type)
 		{
 			case 'HEAD':    // this is a 'HEAD' record
-				g_serializationIntfc->ReadRecordData(buf, length); // copy record contents into a string buffer & print
+				length = g_serializationIntfc->ReadRecordData(buf, (length < sizeof(buf)) ? length : sizeof(buf) - 1); // copy record contents into a string buffer & print
 				buf[length] = 0;
                 _DMESSAGE("HEADER RECORD, Version(%08X): '%s'", version, buf);
 				break;
+            case ExtraDataCosave::kRecordType: // 'XDAT' record, already read & decoded during preload
+                break;
 			default:        // record of unkown type
                 _DMESSAGE("Record Type[%.4s] Version(%08X) Length(%08X)", &type, version, length);
 				break;
 		}
 	}
+    g_extraDataCosave.Apply(); // apply values decoded from 'XDAT' record
     gLog.Outdent();
 }
 static void PreloadCallback(void * reserved)
 {// called *before* game load by obse to deserialize private plugin data from the obse cosave	
+    TraceScope trace("PreloadCallback","Cosave");
     _DMESSAGE("Preload Game callback ...");
+    g_extraDataCosave.Preload(); // read 'XDAT' record & start decoding it in the background
 }
 static void NewGameCallback(void * reserved)
 {// called when a new game is started by obse to initialize private plugin data
+    TraceScope trace("NewGameCallback","Cosave");
     _DMESSAGE("New Game callback ...");
+    g_extraDataCosave.Reset(); // discard any values decoded by an unfinished load
 }
 
 /*--------------------------------------------------------------------------------------------*/
@@ -122,23 +127,39 @@ void GeneralMessageHandler(OBSEMessagingInterface::Message* msg)
         {
             _VMESSAGE("Attached to CSE console");
             gLog.AttachTarget(_CSETarget);   // attach CSE console target to output log
-            _CSETarget.LoadRulesFromINI("Data\\obse\\Plugins\\" SOLUTIONNAME "\\Settings.ini","CSEConsole.Log"); // load target rules for CSE console
+            _CSETarget.LoadRulesFromINI(SETTINGS_INI,"CSEConsole.Log"); // load target rules for CSE console
             _CSETarget.consoleStyle.includeTime = _CSETarget.consoleStyle.includeSource = false; // setup output style for console
             g_cseConsoleInfc->RegisterCallback(CSEPrintCallback); // register parser for CSE console output
+            _CSETarget.StartFlushTimer(); // start idle flush timer for batched console output
         }
         return;
     }
+    if (msg->type == 'MYFB')
+    {
+        // bulk data interface request, reply with a pointer to the interface
+        _VMESSAGE("Received bulk interface request from '%s'", msg->sender);
+        const MyFormBulkInterface* bulkIntfc = g_submoduleInfc ? g_submoduleInfc->BulkInterface() : NULL;
+        if (!bulkIntfc) _WARNING("Bulk interface requested by '%s' before submodule was initialized", msg->sender);
+        else if (msg->sender) g_messagingIntfc->Dispatch(g_pluginHandle, 'MYFB', (void*)bulkIntfc, sizeof(MyFormBulkInterface), msg->sender);
+        return;
+    }
     _VMESSAGE("Received unknown message type=%i from '%s' w/ data <%p> len=%04X", msg->type, msg->sender, msg->data, msg->dataLen);
 }
 void OBSEMessageHandler(OBSEMessagingInterface::Message* msg)
 {// registered during plugin load; recieves (event) messages from OBSE itself
+    TraceScope trace("OBSEMessage","OBSE",msg->type);
 	switch (msg->type)
 	{
 	case OBSEMessagingInterface::kMessage_ExitGame:
 		_VMESSAGE("Received 'exit game' message");
+        FlushTrace();
+        g_commandRecorder.Flush();
 		break;
 	case OBSEMessagingInterface::kMessage_ExitToMainMenu:
 		_VMESSAGE("Received 'exit game to main menu' message");
+        FlushTrace();
+        g_commandRecorder.Flush();
+        if (g_submoduleInfc) g_submoduleInfc->CommitMyFormWrites(); // apply staged writes from the game session
 		break;
 	case OBSEMessagingInterface::kMessage_PostLoad:
 		_VMESSAGE("Received 'post-load' message"); 
@@ -152,18 +173,28 @@ void OBSEMessageHandler(OBSEMessagingInterface::Message* msg)
 		break;
 	case OBSEMessagingInterface::kMessage_PreLoadGame:
 		_VMESSAGE("Received 'pre-load game' message with file path %s", msg->data);
+        if (g_submoduleInfc) g_submoduleInfc->CommitMyFormWrites(); // apply staged writes before game state is replaced
 		break;
 	case OBSEMessagingInterface::kMessage_ExitGame_Console:
 		_VMESSAGE("Received 'quit game from console' message");
+        FlushTrace();
+        g_commandRecorder.Flush();
 		break;
     case OBSEMessagingInterface::kMessage_PostLoadGame:
         _VMESSAGE("Received 'post-load game' message");
+        if (g_submoduleInfc) g_submoduleInfc->CommitMyFormWrites(); // publish loaded state for worker threads
         break;
     case 9: // TODO - use appropriate constant
         _VMESSAGE("Received post-post-load message");
-        // request a CSE interface
-        _VMESSAGE("Requesting CSE interface ... ");
-        g_messagingIntfc->Dispatch(g_pluginHandle, 'CSEI', NULL, 0, "CSE");
+        {
+            // request a CSE interface
+            StartupPhase phase("CSE handshake");
+            _VMESSAGE("Requesting CSE interface ... ");
+            g_messagingIntfc->Dispatch(g_pluginHandle, 'CSEI', NULL, 0, "CSE");
+        }
+        // startup is complete, write startup report
+        g_startupProfiler.WriteReport(g_obseIntfc->isEditor ? "Data\\obse\\plugins\\" SOLUTIONNAME "\\CS.Startup.json"
+                                                            : "Data\\obse\\plugins\\" SOLUTIONNAME "\\Game.Startup.json");
         break;
 	default:
 		_VMESSAGE("Received OBSE message type=%i from '%s' w/ data <%p> len=%04X", msg->type, msg->sender, msg->data, msg->dataLen);
@@ -175,13 +206,28 @@ void OBSEMessageHandler(OBSEMessagingInterface::Message* msg)
 // OBSE plugin query
 extern "C" bool _declspec(dllexport) OBSEPlugin_Query(const OBSEInterface* obse, PluginInfo* info)
 {
+    StartupPhase queryPhase("OBSEPlugin_Query");
+
     // attach html-formatted log file to loader output handler
     HTMLTarget* tgt = (obse->isEditor) ? new HTMLTarget("Data\\obse\\plugins\\" SOLUTIONNAME "\\CS.log.html",SOLUTIONNAME " CS Log")
                                        : new HTMLTarget("Data\\obse\\plugins\\" SOLUTIONNAME "\\Game.log.html",SOLUTIONNAME " Game Log");
     _gLogFile = tgt;
     gLog.AttachTarget(*_gLogFile);
      // load rules for loader output from INI
-    tgt->LoadRulesFromINI("Data\\obse\\Plugins\\" SOLUTIONNAME "\\Settings.ini",obse->isEditor ? "CS.Log" : "Game.Log");
+    tgt->LoadRulesFromINI(SETTINGS_INI,obse->isEditor ? "CS.Log" : "Game.Log");
+
+    // attach flight recorder, if enabled; it records all channels, regardless of the log file rules
+    if (GetSettingInt("FlightRecorder","Enabled",0))
+    {
+        _FlightRecorderTarget.Enable(GetSettingInt("FlightRecorder","Lines",0x100));
+        gLog.AttachTarget(_FlightRecorderTarget);
+    }
+
+    // begin activity tracing, if enabled
+    if (GetSettingInt("Trace","Enabled",0)) gTrace.Enable(GetSettingInt("Trace","Capacity",0x10000));
+
+    // begin recording script commands, if enabled (scripts only run in game)
+    if (!obse->isEditor && GetSettingInt("Recorder","Enabled",0)) g_commandRecorder.Enable(COMMAND_RECORDING_PATH,GetSettingInt("Recorder","Capacity",0x1000));
 
 	// fill out plugin info structure
 	info->infoVersion = PluginInfo::kInfoVersion;   // info structure version
@@ -201,7 +247,10 @@ extern "C" bool _declspec(dllexport) OBSEPlugin_Query(const OBSEInterface* obse,
     // ExportInjector *must* be loaded before the submodule, since loading the submodule will explicitly require the export table
     // Technically, only the first COEF-based plugin needs to perform this step; further LoadLibrary calls on ExportInjector.dll will do nothing
     _MESSAGE("Loading ExportInjector ...");
-    g_hExportInjector = LoadLibrary("Data\\obse\\Plugins\\COEF\\API\\ExportInjector.dll");
+    {
+        StartupPhase phase("LoadLibrary ExportInjector");
+        g_hExportInjector = LoadLibrary("Data\\obse\\Plugins\\COEF\\API\\ExportInjector.dll");
+    }
     if (g_hExportInjector)
     {
         _DMESSAGE("ExportInjector loaded at <%p>", g_hExportInjector);
@@ -218,7 +267,12 @@ extern "C" bool _declspec(dllexport) OBSEPlugin_Query(const OBSEInterface* obse,
     _MESSAGE("Loading COEF Components ...");
     const char* componentlib = obse->isEditor ? "Data\\obse\\Plugins\\COEF\\Components\\Components.CS.dll" 
                                               : "Data\\obse\\Plugins\\COEF\\Components\\Components.Game.dll" ;
-    if (LoadLibrary(componentlib))
+    HMODULE hComponents = 0;
+    {
+        StartupPhase phase("LoadLibrary Components");
+        hComponents = LoadLibrary(componentlib);
+    }
+    if (hComponents)
     {
         _DMESSAGE("COEF components loaded successfully");
     }
@@ -234,7 +288,10 @@ extern "C" bool _declspec(dllexport) OBSEPlugin_Query(const OBSEInterface* obse,
     const char* modulename = obse->isEditor ? "Data\\obse\\plugins\\" SOLUTIONNAME "\\Submodule.CS.dll" 
                                             : "Data\\obse\\plugins\\" SOLUTIONNAME "\\Submodule.Game.dll";
     _MESSAGE("Loading Submodule '%s' ...", modulename);
-    g_hSubmodule = LoadLibrary(modulename);
+    {
+        StartupPhase phase("LoadLibrary Submodule");
+        g_hSubmodule = LoadLibrary(modulename);
+    }
     if (g_hSubmodule)
     {
         _DMESSAGE("Submodule loaded at <%p>", g_hSubmodule);
@@ -297,10 +354,40 @@ extern "C" bool _declspec(dllexport) OBSEPlugin_Query(const OBSEInterface* obse,
 	return true;
 }
 
+/*--------------------------------------------------------------------------------------------*/
+// Submodule initialization
+void InitializeSubmodule()
+{
+    /*
+        Calls the Initialize() method exported by the submodule, which registers new form types and
+        writes hooks & patches, and returns the submodule interface.
+        Called during plugin load.  New form types must be registered before any data files are loaded,
+        and the remaining submodule state (form & EditorID indexes, snapshots, conflict records) is
+        already created on first use, so there is nothing left to defer.
+    */
+    if (g_submoduleInfc) return; // already initialized
+    StartupPhase phase("Submodule Initialize");
+    FARPROC pQuerySubmodule = GetProcAddress(g_hSubmodule,"Initialize"); // get pointer to Initialize() method exported by submodule
+    if (pQuerySubmodule) 
+    {
+        g_submoduleInfc = (SubmoduleInterface*)pQuerySubmodule();   // call Submodule::Initialize() method, returns submodule interface
+        if (!g_submoduleInfc) 
+        {
+            _ERROR("Submodule returned invalid interface");
+        }
+        _DMESSAGE("Submodule interface found at <%p>",g_submoduleInfc);
+    }
+    else _ERROR("Could not initialize submodule.");
+
+    // attach submodule to script commands
+    Initialize_Commands();
+}
+
 /*--------------------------------------------------------------------------------------------*/
 // OBSE plugin load
 extern "C" bool _declspec(dllexport) OBSEPlugin_Load(const OBSEInterface * obse)
 {
+    StartupPhase loadPhase("OBSEPlugin_Load");
 	_MESSAGE("OBSE Load (CSMode = %i)",obse->isEditor);
 
     // get obse interface, plugin handle
@@ -329,20 +416,13 @@ extern "C" bool _declspec(dllexport) OBSEPlugin_Load(const OBSEInterface * obse)
 	g_cmdIntfc = (OBSECommandTableInterface*)obse->QueryInterface(kInterface_CommandTable);
 
     // initialize submodule
-    FARPROC pQuerySubmodule = GetProcAddress(g_hSubmodule,"Initialize"); // get pointer to Initialize() method exported by submodule
-    if (pQuerySubmodule) 
-    {
-        g_submoduleInfc = (SubmoduleInterface*)pQuerySubmodule();   // call Submodule::Initialize() method, returns submodule interface
-        if (!g_submoduleInfc) 
-        {
-            _ERROR("Submodule returned invalid interface");
-        }
-        _DMESSAGE("Submodule interface found at <%p>",g_submoduleInfc);
-    }
-    else _ERROR("Could not initialize submodule.");
+    InitializeSubmodule();
 
     // Register script commands
-    Register_Commands();
+    {
+        StartupPhase phase("Register_Commands");
+        Register_Commands();
+    }
 
 	return true;
 }
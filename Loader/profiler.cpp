@@ -0,0 +1,55 @@
+/*
+    Startup profiler unit for loader
+*/
+#include "Loader/profiler.h"
+#include "Submodule/Timing.h"
+#include "Submodule/Version.h"
+
+/*--------------------------------------------------------------------------------------------*/
+StartupProfiler g_startupProfiler;
+
+StartupProfiler::StartupProfiler()
+: count(0), depth(0)
+{
+}
+UInt32 StartupProfiler::Begin(const char* name)
+{
+    // depth is tracked even when the phase table is full, since End() is called for every Begin()
+    UInt32 phaseDepth = depth++;
+    if (count >= kMaxPhases) return kMaxPhases; // phase table is full, phase will not be recorded
+    Phase& phase = phases[count];
+    phase.name = name;
+    phase.depth = phaseDepth;
+    phase.end = 0;
+    phase.start = PerfTicks();
+    return count++;
+}
+void StartupProfiler::End(UInt32 index)
+{
+    UInt64 end = PerfTicks();
+    depth--;
+    if (index < count) phases[index].end = end;
+}
+bool StartupProfiler::WriteReport(const char* path)
+{
+    FILE* file = 0;
+    if (fopen_s(&file,path,"w") != 0 || !file)
+    {
+        _ERROR("Could not open startup report '%s'",path);
+        return false;
+    }
+    // times are reported in microseconds, relative to the start of the first phase
+    UInt64 origin = count ? phases[0].start : 0;
+    fprintf(file,"{\n  \"plugin\": \"%s\",\n  \"version\": \"%08X\",\n  \"phases\": [\n", SOLUTIONNAME, RECORD_VERSION(0));
+    for (UInt32 i = 0; i < count; i++)
+    {
+        const Phase& phase = phases[i];
+        fprintf(file,"    { \"name\": \"%s\", \"depth\": %u, \"start_us\": %.1f, \"duration_us\": %.1f }%s\n",
+            phase.name, phase.depth, PerfTicksToUS(phase.start - origin),
+            phase.end ? PerfTicksToUS(phase.end - phase.start) : -1.0, (i + 1 < count) ? "," : "");
+    }
+    fprintf(file,"  ]\n}\n");
+    fclose(file);
+    _DMESSAGE("Wrote startup report '%s' with %i phases",path,count);
+    return true;
+}
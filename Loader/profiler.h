@@ -0,0 +1,46 @@
+/*
+    Startup profiler for loader
+    Records the duration of each loader stage (plugin query & load, library loading, submodule
+    initialization, etc.), and writes them to a machine readable (JSON) report once startup is complete.
+*/
+#pragma once
+
+class StartupProfiler
+{
+public:
+    static const UInt32 kMaxPhases = 0x40;
+
+    struct Phase
+    {
+        const char*     name;       // static string
+        UInt32          depth;      // nesting depth, zero for top-level phases
+        UInt64          start;      // performance counter ticks
+        UInt64          end;        // performance counter ticks, zero if phase has not ended
+    };
+
+    // methods
+    UInt32          Begin(const char* name);    // starts a new phase, nested in any open phases, and returns its index
+    void            End(UInt32 phase);          // ends a phase started by Begin()
+    bool            WriteReport(const char* path); // writes all phases recorded so far to a JSON file
+
+    // constructor
+    StartupProfiler();
+
+private:
+    Phase           phases[kMaxPhases];
+    UInt32          count;
+    UInt32          depth;
+};
+
+// global startup profiler
+extern StartupProfiler g_startupProfiler;
+
+// Times the enclosing scope as a startup phase
+class StartupPhase
+{
+public:
+    StartupPhase(const char* name) : index(g_startupProfiler.Begin(name)) {}
+    ~StartupPhase() { g_startupProfiler.End(index); }
+private:
+    UInt32  index;
+};
@@ -0,0 +1,142 @@
+/*
+    Script command recorder & replay unit for loader
+*/
+#include "Loader/recorder.h"
+#include "Loader/commands.h"
+
+#include <vector>
+#include <algorithm>
+#include <share.h>
+
+// local declaration of direct dispatch table defined in commands.cpp
+extern const SubmoduleCommandTable* g_submoduleCmds;
+
+/*--------------------------------------------------------------------------------------------*/
+CommandRecorder g_commandRecorder;
+
+CommandRecorder::CommandRecorder()
+: enabled(false), records(0), capacity(0), count(0), total(0), file(0)
+{
+}
+CommandRecorder::~CommandRecorder()
+{
+    if (file) fclose(file);
+    delete [] records;
+}
+void CommandRecorder::Enable(const char* path, UInt32 newCapacity)
+{
+    if (enabled || !newCapacity) return;
+    // fopen_s opens files for exclusive access; other readers (e.g. a copy taken while the game is running)
+    // are allowed, other writers are not
+    file = _fsopen(path,"wb",_SH_DENYWR);
+    if (!file)
+    {
+        _ERROR("Could not open command recording '%s'",path);
+        return;
+    }
+    RecordingHeader header = { RecordingHeader::kMagic, RecordingHeader::kVersion, PerfFrequency() };
+    fwrite(&header,sizeof(header),1,file);
+    records = new CallRecord[newCapacity]();    // zero-initialized, so padding is written as zero
+    capacity = newCapacity;
+    count = total = 0;
+    enabled = true;
+    _MESSAGE("Recording script commands to '%s'",path);
+}
+bool CommandRecorder::Flush()
+{
+    if (!file) return false;
+    if (count && fwrite(records,sizeof(CallRecord),count,file) != count)
+    {
+        _ERROR("Could not write command recording, recording stopped");
+        enabled = false;
+    }
+    fflush(file);
+    total += count;
+    count = 0;
+    _VMESSAGE("Command recording: %i calls written",total);
+    return enabled;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// replay
+SInt32 ReplayCommandRecording(const char* path)
+{
+    if (!g_submoduleCmds) return -1;    // replay calls the direct dispatch handlers
+    if (g_commandRecorder.enabled) g_commandRecorder.Flush(); // so the current session can be replayed
+
+    // read recording
+    FILE* file = _fsopen(path,"rb",_SH_DENYNO);  // the recorder may still have the file open for writing
+    if (!file)
+    {
+        _ERROR("Could not open command recording '%s'",path);
+        return -1;
+    }
+    CommandRecorder::RecordingHeader header;
+    std::vector<CommandRecorder::CallRecord> calls;
+    if (fread(&header,sizeof(header),1,file) == 1 && header.magic == CommandRecorder::RecordingHeader::kMagic
+        && header.version == CommandRecorder::RecordingHeader::kVersion)
+    {
+        CommandRecorder::CallRecord record;
+        while (fread(&record,sizeof(record),1,file) == 1) calls.push_back(record);
+    }
+    else _ERROR("'%s' is not a command recording",path);
+    fclose(file);
+    if (calls.empty()) return 0;
+
+    // resolve MyForms once, before timing; remember original extraData of every form the recording writes
+    std::vector<TESForm*> forms(calls.size());
+    std::vector<std::pair<TESForm*,UInt32> > originals;
+    g_submoduleInfc->CommitMyFormWrites();
+    for (UInt32 i = 0; i < calls.size(); i++)
+    {
+        TESForm* const* found = 0;
+        forms[i] = (calls[i].formID && g_submoduleInfc->GetMyFormsInRange(calls[i].formID,calls[i].formID,found)) ? found[0] : 0;
+        if (forms[i] && calls[i].opcode == CommandRecorder::kOpcode_SetMyFormExtraData)
+        {
+            originals.push_back(std::make_pair(forms[i],g_submoduleCmds->GetMyFormExtraData(forms[i])));
+        }
+    }
+
+    // replay back to back, timing each call
+    std::vector<UInt64> latencies[3];
+    UInt32 skipped = 0;
+    for (UInt32 i = 0; i < calls.size(); i++)
+    {
+        const CommandRecorder::CallRecord& call = calls[i];
+        if (call.opcode > CommandRecorder::kOpcode_SetMyFormExtraData || (call.opcode != CommandRecorder::kOpcode_ListMyForms && !forms[i]))
+        {
+            skipped++; // unknown opcode, or form is not loaded
+            continue;
+        }
+        UInt64 start = PerfTicks();
+        switch (call.opcode)
+        {
+        case CommandRecorder::kOpcode_ListMyForms:          g_submoduleInfc->ListMyForms(); break;
+        case CommandRecorder::kOpcode_GetMyFormExtraData:   g_submoduleCmds->GetMyFormExtraData(forms[i]); break;
+        case CommandRecorder::kOpcode_SetMyFormExtraData:   g_submoduleCmds->SetMyFormExtraData(forms[i],call.arg); break;
+        }
+        latencies[call.opcode].push_back(PerfTicks() - start);
+    }
+
+    // restore original state, in reverse so the earliest original wins
+    g_submoduleInfc->CommitMyFormWrites();
+    for (UInt32 i = originals.size(); i-- > 0;) g_submoduleCmds->SetMyFormExtraData(originals[i].first,originals[i].second);
+    g_submoduleInfc->CommitMyFormWrites();
+
+    // report
+    static const char* opcodeNames[3] = { "ListMyForms", "GetMyFormExtraData", "SetMyFormExtraData" };
+    double recordedMS = (calls.back().timestamp - calls.front().timestamp) * 1000.0 / (header.frequency ? header.frequency : 1);
+    _MESSAGE("Replayed %i calls from '%s' (%i skipped), recorded over %.3f ms",calls.size() - skipped,path,skipped,recordedMS);
+    gLog.Indent();
+    for (UInt32 op = 0; op < 3; op++)
+    {
+        std::vector<UInt64>& times = latencies[op];
+        if (times.empty()) continue;
+        std::sort(times.begin(),times.end());
+        UInt32 n = times.size();
+        _MESSAGE("%s: %i calls, latency p50=%.2f us, p90=%.2f us, p99=%.2f us, max=%.2f us",opcodeNames[op],n,
+            PerfTicksToUS(times[n/2]),PerfTicksToUS(times[n*9/10]),PerfTicksToUS(times[n*99/100]),PerfTicksToUS(times[n-1]));
+    }
+    gLog.Outdent();
+    return calls.size() - skipped;
+}
@@ -0,0 +1,76 @@
+/*
+    Script command recorder for loader
+    Records the MyForm script commands executed during a session as compact binary call records, so that
+    a user's workload can be replayed exactly, in-game, with the ReplayMyFormCommands command.
+
+    Records are buffered in memory and appended to the recording file whenever the buffer fills up, and
+    on exit.  File format: a RecordingHeader, followed by CallRecords in call order.
+*/
+#pragma once
+
+#include "Submodule/Timing.h"
+
+// default recording file
+#define COMMAND_RECORDING_PATH "Data\\obse\\plugins\\" SOLUTIONNAME "\\Commands.rec"
+
+class CommandRecorder
+{
+public:
+    enum Opcodes
+    {
+        kOpcode_ListMyForms         = 0,
+        kOpcode_GetMyFormExtraData  = 1,
+        kOpcode_SetMyFormExtraData  = 2,
+    };
+
+    struct RecordingHeader
+    {
+        enum { kMagic = 'RCYM', kVersion = 1 };  // magic reads as "MYCR" in the file
+        UInt32      magic;
+        UInt32      version;
+        UInt64      frequency;  // performance counter frequency, for converting timestamps
+    };
+    struct CallRecord
+    {
+        UInt8       opcode;     // from Opcodes
+        UInt8       pad01[3];
+        UInt32      formID;     // MyForm argument, or zero if the argument was not a MyForm
+        UInt32      arg;        // integer argument, if any
+        UInt32      pad0C;
+        UInt64      timestamp;  // performance counter ticks at start of call
+    };
+
+    // members
+    bool            enabled;
+
+    // methods, main thread only
+    void            Enable(const char* path, UInt32 capacity);  // starts recording to a new file
+    inline void     Record(UInt8 opcode, UInt32 formID, UInt32 arg)
+    {
+        if (!enabled) return;
+        CallRecord& record = records[count++];
+        record.opcode = opcode;
+        record.formID = formID;
+        record.arg = arg;
+        record.timestamp = PerfTicks();
+        if (count >= capacity) Flush();
+    }
+    bool            Flush();    // appends buffered records to the recording file
+
+    // constructor, destructor
+    CommandRecorder();
+    ~CommandRecorder();
+
+private:
+    CallRecord*     records;
+    UInt32          capacity;
+    UInt32          count;      // buffered records
+    UInt32          total;      // records written to file
+    FILE*           file;
+};
+
+// global command recorder
+extern CommandRecorder g_commandRecorder;
+
+// replays a recording against the current MyForms & logs latency percentiles, returns number of calls replayed
+SInt32 ReplayCommandRecording(const char* path);
@@ -0,0 +1,123 @@
+/*
+    Custom output targets unit for loader
+*/
+#include "Loader/targets.h"
+#include "Loader/commands.h"
+#include "Submodule/CSE_Interface.h"
+
+// local declarations of CSE console interface & log file target defined in loader.cpp
+extern CSEConsoleInterface* g_cseConsoleInfc;
+extern OutputTarget*        _gLogFile;
+
+/*--------------------------------------------------------------------------------------------*/
+// CSE console output target
+CSEConsoleTarget _CSETarget;
+
+void CSEConsoleTarget::WriteOutputLine(const OutputStyle& style, time_t time, int channel, const char* source, const char* text)
+{
+    if (!g_cseConsoleInfc || !g_cseConsoleInfc->PrintToConsole) return;  // bad CSE console interface
+    EnterCriticalSection(&lock);
+    BufferTarget::WriteOutputLine(consoleStyle,time,channel,source,text); // generate output line, without timestamp or source
+    const char* line = LastOutputLine();
+    UInt32 length = strlen(line);
+    if (pendingLength && pendingLength + length + 1 >= kChunkSize) Flush(); // chunk is full
+    if (length + 1 >= kChunkSize) g_cseConsoleInfc->PrintToConsole(SOLUTIONNAME,line); // line is too long for a chunk
+    else
+    {
+        if (pendingLength) pending[pendingLength++] = '\n';
+        memcpy(pending + pendingLength,line,length + 1);
+        pendingLength += length;
+    }
+    LeaveCriticalSection(&lock);
+}
+void CSEConsoleTarget::Flush()
+{
+    EnterCriticalSection(&lock);
+    if (pendingLength)
+    {
+        char chunk[kChunkSize];
+        memcpy(chunk,pending,pendingLength + 1);
+        pendingLength = 0;  // clear before printing, in case printing re-enters this target
+        g_cseConsoleInfc->PrintToConsole(SOLUTIONNAME,chunk);  // write pending lines to CSE console
+    }
+    LeaveCriticalSection(&lock);
+}
+void CALLBACK CSEConsoleTarget::FlushTimerProc(HWND hwnd, UINT uMsg, UINT_PTR idEvent, DWORD dwTime)
+{
+    _CSETarget.Flush();
+}
+void FlushCSEConsole()
+{
+    _CSETarget.Flush();
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// Flight recorder output target
+FlightRecorderTarget _FlightRecorderTarget;
+
+void FlightRecorderTarget::WriteOutputLine(const OutputStyle& style, time_t time, int channel, const char* source, const char* text)
+{
+    if (!entries) return;   // not enabled
+    EnterCriticalSection(&lock);
+    if (channel <= kLastErrorChannel) Capture();    // the error line itself has already been written by the log file target
+    else
+    {
+        Entry& entry = entries[next];
+        entry.time = time;
+        entry.channel = channel;
+        strncpy_s(entry.source,sizeof(entry.source),source ? source : "",_TRUNCATE);
+        strncpy_s(entry.text,sizeof(entry.text),text ? text : "",_TRUNCATE);
+        next = (next + 1) % capacity;
+        if (count < capacity) count++;
+    }
+    bool write = pendingCount && GetCurrentThreadId() == mainThreadID;
+    LeaveCriticalSection(&lock);
+    if (write) WritePending();
+}
+void FlightRecorderTarget::Dump()
+{
+    if (!entries) return;
+    EnterCriticalSection(&lock);
+    Capture();
+    bool write = pendingCount && GetCurrentThreadId() == mainThreadID;
+    LeaveCriticalSection(&lock);
+    if (write) WritePending();
+}
+void FlightRecorderTarget::Enable(UInt32 slots)
+{
+    if (entries || !slots) return;
+    entries = new Entry[slots];
+    pending = new Entry[slots];
+    capacity = slots;
+    mainThreadID = GetCurrentThreadId();
+}
+void FlightRecorderTarget::Capture()
+{
+    // if an earlier capture has not been written yet, the lines stay in the ring for the next one
+    if (pendingCount || !count) return;
+    for (UInt32 i = (next + capacity - count) % capacity; pendingCount < count; i = (i + 1) % capacity) pending[pendingCount++] = entries[i];
+    count = 0;
+}
+void FlightRecorderTarget::WritePending()
+{
+    // pending lines are not touched by other threads until pendingCount is cleared, so they are written without the lock
+    EnterCriticalSection(&lock);
+    UInt32 lines = pendingCount;
+    LeaveCriticalSection(&lock);
+    if (!lines) return;
+    if (_gLogFile)
+    {
+        char header[0x80];
+        sprintf_s(header,sizeof(header),"---------- Flight recorder: last %i lines ----------",lines);
+        _gLogFile->WriteOutputLine(dumpStyle,::time(NULL),3,SOLUTIONNAME,header);
+        for (UInt32 i = 0; i < lines; i++) _gLogFile->WriteOutputLine(dumpStyle,pending[i].time,pending[i].channel,pending[i].source,pending[i].text);
+        _gLogFile->WriteOutputLine(dumpStyle,::time(NULL),3,SOLUTIONNAME,"---------- End of flight recorder ----------");
+    }
+    EnterCriticalSection(&lock);
+    pendingCount = 0;
+    LeaveCriticalSection(&lock);
+}
+void DumpFlightRecorder()
+{
+    _FlightRecorderTarget.Dump();
+}
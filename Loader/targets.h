@@ -0,0 +1,93 @@
+/*
+    Custom output targets for loader
+*/
+#pragma once
+
+/*--------------------------------------------------------------------------------------------*/
+// CSE console output target
+// this is a custom OutputTarget that forwards (plain text) output to the CSE console, if CSE is present 
+// Lines are accumulated and sent to the console in chunks, because each PrintToConsole call is expensive
+// (the console redraws, and echoes the message to every registered callback, including our own).
+// Pending lines are flushed when the chunk is full, at the end of each CSE console command, and by a
+// timer on the CS main thread - WM_TIMER messages are only generated when the message queue is empty,
+// so the timer flushes whenever the CS is idle.
+class CSEConsoleTarget : public BufferTarget
+{
+public:
+    static const UInt32 kChunkSize      = 0x1000;   // maximum size of a single PrintToConsole message
+    static const UInt32 kFlushInterval  = 100;      // idle flush timer period, in milliseconds
+
+    // interface
+    virtual void    WriteOutputLine(const OutputStyle& style, time_t time, int channel, const char* source, const char* text);
+    // sends all pending lines to the console
+    void            Flush();
+    // starts idle flush timer; must be called from the CS main thread
+    void            StartFlushTimer() { if (!timerID) timerID = SetTimer(NULL,0,kFlushInterval,&FlushTimerProc); }
+    static void CALLBACK FlushTimerProc(HWND hwnd, UINT uMsg, UINT_PTR idEvent, DWORD dwTime);
+    // constructor, destructor
+    CSEConsoleTarget() : pendingLength(0), timerID(0) { pending[0] = 0; InitializeCriticalSection(&lock); }
+    ~CSEConsoleTarget() { DeleteCriticalSection(&lock); }
+    // static output style
+    OutputStyle  consoleStyle;
+private:
+    char                pending[kChunkSize];    // pending lines, separated by newlines
+    UInt32              pendingLength;
+    UINT_PTR            timerID;
+    CRITICAL_SECTION    lock;
+};
+
+// global CSE console target
+extern CSEConsoleTarget _CSETarget;
+
+/*--------------------------------------------------------------------------------------------*/
+// Flight recorder output target
+// this is a custom OutputTarget that keeps the most recent output lines on all channels in a fixed ring of
+// text slots, and writes them to the log file only when an error is logged (or on request).  This allows
+// verbose & debug output to be blocked in the log file during normal play, while still providing full context
+// for errors.  Lines are stored already formatted - gLog formats each message once for all targets, so
+// recording costs one bounded copy per line, and no allocation.
+// Lines may be logged from any thread, but the log file is only written on the main thread: a dump copies the
+// ring into a pending buffer under the lock, and the main thread writes the pending lines at the dump itself,
+// or at the next line it logs if the dump was requested from another thread.
+class FlightRecorderTarget : public BufferTarget
+{
+public:
+    static const UInt32 kSourceSize     = 0x20;     // source strings are truncated to this length
+    static const UInt32 kTextSize       = 0xC0;     // message text is truncated to this length
+    static const int    kLastErrorChannel = 1;      // channels are ordered Fatal, Error, Warning, Message, Verbose, Debug
+
+    // interface
+    virtual void    WriteOutputLine(const OutputStyle& style, time_t time, int channel, const char* source, const char* text);
+    // writes all recorded lines to the log file, oldest first, and clears them; deferred if not on the main thread
+    void            Dump();
+    // allocates ring & pending buffer; recording starts once the target is attached to the log
+    // must be called from the main thread, which is the only thread that writes dumps to the log file
+    void            Enable(UInt32 slots);
+    // constructor, destructor
+    FlightRecorderTarget() : entries(0), pending(0), capacity(0), count(0), next(0), pendingCount(0), mainThreadID(0) { InitializeCriticalSection(&lock); }
+    ~FlightRecorderTarget() { DeleteCriticalSection(&lock); delete [] entries; delete [] pending; }
+    // output style for dumped lines
+    OutputStyle  dumpStyle;
+private:
+    struct Entry
+    {
+        time_t      time;
+        int         channel;
+        char        source[kSourceSize];
+        char        text[kTextSize];
+    };
+    void                Capture();      // moves recorded lines into the pending buffer, if it is empty; lock must be held
+    void                WritePending(); // writes pending lines to the log file; main thread only
+
+    Entry*              entries;    // ring of slots
+    Entry*              pending;    // lines captured for the next write to the log file, oldest first
+    UInt32              capacity;
+    UInt32              count;      // recorded lines not yet captured
+    UInt32              next;       // slot for next line
+    UInt32              pendingCount;   // captured lines not yet written
+    DWORD               mainThreadID;
+    CRITICAL_SECTION    lock;
+};
+
+// global flight recorder target
+extern FlightRecorderTarget _FlightRecorderTarget;
@@ -0,0 +1,60 @@
+/*
+    Activity tracing unit for loader.  Handles:
+    -   global trace recorder, shared with the submodule
+    -   writing recorded spans to a trace event JSON file
+*/
+#include "Submodule/Trace.h"
+#include "Loader/commands.h"
+
+/*--------------------------------------------------------------------------------------------*/
+// global trace recorder
+_declspec(dllexport) TraceRecorder _gTrace;
+TraceRecorder& gTrace = _gTrace;
+
+/*--------------------------------------------------------------------------------------------*/
+void TraceRecorder::Enable(UInt32 newCapacity)
+{
+    if (enabled || !newCapacity) return;
+    events = new TraceEvent[newCapacity](); // zero-initialized, so unfinished slots can be detected
+    capacity = newCapacity;
+    count = 0;
+    origin = PerfTicks();
+    enabled = true; // set last, so no event can be recorded before the buffer is ready
+    _MESSAGE("Tracing enabled, capacity %i events",capacity);
+}
+bool TraceRecorder::Flush(const char* path)
+{
+    if (!events) return false;
+    FILE* file = 0;
+    if (fopen_s(&file,path,"w") != 0 || !file)
+    {
+        _ERROR("Could not open trace file '%s'",path);
+        return false;
+    }
+    UInt32 recorded = count;
+    UInt32 written = (recorded < capacity) ? recorded : capacity;
+    UInt32 pid = GetCurrentProcessId();
+    fprintf(file,"{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+    fprintf(file,"{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":0,\"args\":{\"name\":\"%s\"}}",pid,SOLUTIONNAME);
+    for (UInt32 i = 0; i < written; i++)
+    {
+        const TraceEvent& event = events[i];
+        if (event.end < origin) continue; // slot reserved by a thread that has not finished writing it
+        fprintf(file,",\n{\"name\":\"%s\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%u,\"tid\":%u,\"args\":{\"arg\":\"%08X\"}}",
+            event.name, event.category, PerfTicksToUS(event.start - origin), PerfTicksToUS(event.end - event.start),
+            pid, event.threadID, event.arg);
+    }
+    fprintf(file,"\n]}\n");
+    fclose(file);
+    if (recorded > capacity) _WARNING("Trace buffer full, %i events dropped",recorded - capacity);
+    _MESSAGE("Wrote %i trace events to '%s'",written,path);
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+void FlushTrace()
+{
+    if (!gTrace.enabled) return;
+    gTrace.Flush(g_obseIntfc->isEditor ? "Data\\obse\\plugins\\" SOLUTIONNAME "\\CS.trace.json"
+                                       : "Data\\obse\\plugins\\" SOLUTIONNAME "\\Game.trace.json");
+}
@@ -0,0 +1,53 @@
+#include "Submodule/BulkInterface.h"
+#include "Submodule/Interface.h"
+#include "Submodule/Snapshot.h"
+
+// local declaration of submodule interface defined in submodule.cpp
+extern SubmoduleInterface g_submoduleIntfc;
+
+/*--------------------------------------------------------------------------------------------*/
+// bulk interface handlers, thin wrappers around the MyForm snapshot publisher
+UInt32 Bulk_Generation()
+{
+    return g_myFormSnapshots.Generation();
+}
+bool Bulk_AcquireView(MyFormBulkView* view)
+{
+    if (!view) return false;
+    memset(view,0,sizeof(MyFormBulkView));
+    const MyFormSnapshot* snapshot = g_myFormSnapshots.Acquire();
+    if (!snapshot) return false;
+    view->generation = snapshot->generation;
+    view->count = snapshot->count;
+    view->formIDs = snapshot->formIDs;
+    view->extraData = snapshot->extraData;
+    view->goldValues = snapshot->goldValues;
+    view->weights = snapshot->weights;
+    view->handle = snapshot;
+    return true;
+}
+void Bulk_ReleaseView(MyFormBulkView* view)
+{
+    if (!view || !view->handle) return;
+    g_myFormSnapshots.Release((const MyFormSnapshot*)view->handle);
+    memset(view,0,sizeof(MyFormBulkView));
+}
+UInt32 Bulk_Refresh()
+{
+    g_submoduleIntfc.CommitMyFormWrites();  // commits, and publishes if anything changed
+    return g_myFormSnapshots.Generation();
+}
+
+/*--------------------------------------------------------------------------------------------*/
+const MyFormBulkInterface* SubmoduleInterface::BulkInterface()
+{
+    static const MyFormBulkInterface bulkInterface = 
+    {
+        MyFormBulkInterface::kVersion,
+        &Bulk_Generation,
+        &Bulk_AcquireView,
+        &Bulk_ReleaseView,
+        &Bulk_Refresh
+    };
+    return &bulkInterface;
+}
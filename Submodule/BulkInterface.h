@@ -0,0 +1,48 @@
+#pragma once
+
+/*** MyForm Bulk Data Interface *************
+*   Read-only, zero-copy access to the scalar fields of all MyForms, for other plugins.
+*   A pointer to the interface object will be dispatched to plugins that pass an arbitrary
+*   message of type 'MYFB' to this plugin (by name) post plugin load.  The reply is a
+*   message of type 'MYFB' whose data is a pointer to the interface.  Check the version
+*   before use.
+*
+*   Field data is exposed as parallel columns of a published snapshot.  Snapshots are
+*   immutable, and a new one is published with a higher generation whenever MyForm data has
+*   changed and is committed: before saving, after loading a game, when staged script writes are
+*   committed, or when Refresh() is called.  Script writes that are not staged appear in the next
+*   snapshot.  If nothing has changed, no snapshot is published and the generation stays the same,
+*   so consumers that cache data can compare Generation() with the generation of their cached
+*   view, and only reacquire when it has changed.
+*
+*   This header is self-contained, and may be copied into other plugin projects.
+********************************************/
+
+struct MyFormBulkView
+{
+   UInt32         generation;    // generation of the snapshot
+   UInt32         count;         // number of forms, i.e. length of each column
+   const UInt32*  formIDs;       // columns, indexed in parallel
+   const UInt32*  extraData;
+   const SInt32*  goldValues;
+   const float*   weights;
+   const void*    handle;        // internal, used by ReleaseView()
+};
+
+struct MyFormBulkInterface
+{
+   enum { kVersion = 1 };
+
+   UInt32         version;       // kVersion
+
+   // Returns the generation of the current snapshot, or zero if nothing has been published.  Any thread.
+   UInt32         (* Generation)();
+   // Pins the current snapshot & fills view with its columns.  Returns false (and an empty view) if
+   // nothing has been published.  Any thread.  The columns remain valid until ReleaseView() is called.
+   bool           (* AcquireView)(MyFormBulkView* view);
+   // Unpins a view filled by AcquireView().  Any thread.
+   void           (* ReleaseView)(MyFormBulkView* view);
+   // Commits pending script writes & publishes a new snapshot if anything changed, returns the
+   // generation of the current snapshot.  Main thread only.
+   UInt32         (* Refresh)();
+};
@@ -0,0 +1,103 @@
+#include "Submodule/MyFormColumns.h"
+#include "Submodule/Interface.h"
+#include "Submodule/MyForm.h"
+#include "Submodule/WriteBuffer.h"
+#include "Submodule/EditorIDIndex.h"
+#include "Submodule/FormIndex.h"
+#include "Submodule/Timing.h"
+#include "Submodule/Trace.h"
+
+#include <vector>
+
+/*--------------------------------------------------------------------------------------------*/
+// columnar export, see MyFormColumns.h for the file format
+static UInt32 AddPoolString(std::vector<char>& pool, const char* string)
+{
+    UInt32 offset = pool.size();
+    if (!string) string = "";
+    pool.insert(pool.end(), string, string + strlen(string) + 1);
+    return offset;
+}
+bool SubmoduleInterface::ExportMyFormColumns(const char* path)
+{
+    TraceScope trace("ExportMyFormColumns","MyForm");
+    UInt64 start = PerfTicks();
+
+    // build columns, in formID order
+    TESForm* const* forms = 0;
+    UInt32 count = g_myFormIndex.FindRange(0,0xFFFFFFFF,forms);
+    std::vector<UInt32> formIDs(count), extraData(count);
+    std::vector<UInt8> formTypes(count);
+    std::vector<SInt32> values(count);
+    std::vector<float> weights(count);
+    std::vector<UInt32> stringOffsets[4];   // editorID, name, icon, description
+    for (UInt32 s = 0; s < 4; s++) stringOffsets[s].resize(count);
+    std::vector<char> pool;
+    pool.push_back(0);  // offset 0 is the empty string
+    for (UInt32 i = 0; i < count; i++)
+    {
+        MyForm* myform = (MyForm*)forms[i];
+        formIDs[i] = myform->formID;
+        formTypes[i] = myform->formType;
+        values[i] = myform->goldValue;
+        weights[i] = myform->weight;
+        extraData[i] = g_extraDataWrites.Read(myform);   // include staged writes
+        const char* editorID = g_myFormEditorIDs.EditorID(myform);
+        const char* description = myform->GetDescription(myform,Swap32('DESC'));
+        stringOffsets[0][i] = *editorID ? AddPoolString(pool,editorID) : 0;
+        stringOffsets[1][i] = *myform->name.c_str() ? AddPoolString(pool,myform->name.c_str()) : 0;
+        stringOffsets[2][i] = *myform->texturePath.c_str() ? AddPoolString(pool,myform->texturePath.c_str()) : 0;
+        stringOffsets[3][i] = (description && *description) ? AddPoolString(pool,description) : 0;
+    }
+
+    // lay out column descriptors & data, 8-byte aligned
+    struct ColumnData { UInt32 column; UInt32 elementSize; const void* data; UInt32 size; };
+    ColumnData data[MyFormColumnDesc::kColumn__MAX] = 
+    {
+        { MyFormColumnDesc::kColumn_FormID,      sizeof(UInt32), count ? &formIDs[0] : 0,          count * sizeof(UInt32) },
+        { MyFormColumnDesc::kColumn_FormType,    sizeof(UInt8),  count ? &formTypes[0] : 0,        count * sizeof(UInt8) },
+        { MyFormColumnDesc::kColumn_Value,       sizeof(SInt32), count ? &values[0] : 0,           count * sizeof(SInt32) },
+        { MyFormColumnDesc::kColumn_Weight,      sizeof(float),  count ? &weights[0] : 0,          count * sizeof(float) },
+        { MyFormColumnDesc::kColumn_ExtraData,   sizeof(UInt32), count ? &extraData[0] : 0,        count * sizeof(UInt32) },
+        { MyFormColumnDesc::kColumn_EditorID,    sizeof(UInt32), count ? &stringOffsets[0][0] : 0, count * sizeof(UInt32) },
+        { MyFormColumnDesc::kColumn_Name,        sizeof(UInt32), count ? &stringOffsets[1][0] : 0, count * sizeof(UInt32) },
+        { MyFormColumnDesc::kColumn_Icon,        sizeof(UInt32), count ? &stringOffsets[2][0] : 0, count * sizeof(UInt32) },
+        { MyFormColumnDesc::kColumn_Description, sizeof(UInt32), count ? &stringOffsets[3][0] : 0, count * sizeof(UInt32) },
+        { MyFormColumnDesc::kColumn_Strings,     sizeof(char),   &pool[0],                         pool.size() },
+    };
+    MyFormColumnsHeader header = { MyFormColumnsHeader::kMagic, MyFormColumnsHeader::kVersion, count, MyFormColumnDesc::kColumn__MAX };
+    MyFormColumnDesc descs[MyFormColumnDesc::kColumn__MAX];
+    UInt32 offset = sizeof(header) + sizeof(descs);
+    for (UInt32 c = 0; c < MyFormColumnDesc::kColumn__MAX; c++)
+    {
+        offset = (offset + 7) & ~7;
+        descs[c].column = data[c].column;
+        descs[c].elementSize = data[c].elementSize;
+        descs[c].offset = offset;
+        descs[c].size = data[c].size;
+        offset += data[c].size;
+    }
+
+    // write file
+    FILE* file = 0;
+    if (fopen_s(&file,path,"wb") != 0 || !file)
+    {
+        _ERROR("Could not open column export file '%s'",path);
+        return false;
+    }
+    static const char padding[8] = {0};
+    fwrite(&header,sizeof(header),1,file);
+    fwrite(descs,sizeof(descs),1,file);
+    UInt32 written = sizeof(header) + sizeof(descs);
+    for (UInt32 c = 0; c < MyFormColumnDesc::kColumn__MAX; c++)
+    {
+        fwrite(padding,1,descs[c].offset - written,file);
+        if (data[c].size) fwrite(data[c].data,1,data[c].size,file);
+        written = descs[c].offset + data[c].size;
+    }
+    bool success = !ferror(file);
+    if (fclose(file) != 0) success = false;
+    if (!success) _ERROR("Could not write column export file '%s'",path);
+    else _MESSAGE("Exported %i MyForms (%i bytes) to '%s' in %.3f ms",count,written,path,PerfTicksToMS(PerfTicks() - start));
+    return success;
+}
@@ -0,0 +1,189 @@
+#include "Submodule/ConflictTracker.h"
+#include "Submodule/MyForm.h"
+#include "Submodule/EditorIDIndex.h"
+#include "Submodule/FormIndex.h"
+#include "Submodule/Timing.h"
+#include "Submodule/Trace.h"
+
+#include "API/TESFiles/TESFile.h"
+
+#include <algorithm>
+
+static const char* const kFieldNames[MyFormConflictTracker::kField__MAX] = { "editorID", "name", "description", "icon", "value", "weight", "extraData" };
+static const UInt32 kMaxThreads = 0x10;
+
+// FNV-1a hash of a block of memory
+static UInt32 HashBytes(const void* data, UInt32 size)
+{
+    UInt32 hash = 0x811C9DC5;
+    for (const UInt8* c = (const UInt8*)data; size; c++, size--) hash = (hash ^ *c) * 0x01000193;
+    return hash;
+}
+static UInt32 HashString(const char* string) { return string ? HashBytes(string,strlen(string)) : HashBytes(0,0); }
+
+/*--------------------------------------------------------------------------------------------*/
+MyFormConflictTracker g_myFormConflicts;
+
+MyFormConflictTracker::MyFormConflictTracker()
+: enabled(false), threads(0)
+{
+}
+MyFormConflictTracker::~MyFormConflictTracker()
+{
+    for (UInt32 i = 0; i < fileNames.size(); i++) free(fileNames[i]);
+}
+void MyFormConflictTracker::Record(MyForm* form, TESFile& file)
+{
+    if (!enabled) return;
+    // files are loaded one at a time, so the source file is almost always the last one seen
+    UInt32 fileIndex = fileNames.size();
+    if (fileIndex && _stricmp(fileNames.back(),file.fileName) == 0) fileIndex--;
+    else if (fileIndex < 0x10000) fileNames.push_back(_strdup(file.fileName));
+    else return; // file table is full
+
+    Version version;
+    version.formID = form->formID;
+    version.fileIndex = fileIndex;
+    version.pad06 = 0;
+    version.hashes[kField_EditorID] = HashString(g_myFormEditorIDs.EditorID(form));
+    version.hashes[kField_Name] = HashString(form->name.c_str());
+    #ifndef OBLIVION
+    version.hashes[kField_Description] = HashString(form->GetDescription(form,Swap32('DESC')));
+    #else
+    version.hashes[kField_Description] = 0;
+    #endif
+    version.hashes[kField_Icon] = HashString(form->texturePath.c_str());
+    version.hashes[kField_Value] = HashBytes(&form->goldValue,sizeof(form->goldValue));
+    version.hashes[kField_Weight] = HashBytes(&form->weight,sizeof(form->weight));
+    version.hashes[kField_ExtraData] = HashBytes(&form->extraData,sizeof(form->extraData));
+    versions.push_back(version);
+}
+UInt32 MyFormConflictTracker::MemoryUsage()
+{
+    return versions.capacity() * sizeof(Version) + fileNames.capacity() * sizeof(char*) 
+        + order.capacity() * sizeof(UInt32) + results.capacity() * sizeof(Result);
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// analysis
+void MyFormConflictTracker::Analyze(UInt32 firstGroup, UInt32 lastGroup)
+{
+    // worker thread - reads versions & order, writes only its own range of results
+    for (UInt32 g = firstGroup; g < lastGroup; g++)
+    {
+        Result& result = results[g];
+        const Version& master = versions[order[result.first]];
+        const Version& winner = versions[order[result.first + result.count - 1]];
+        result.overridden = result.conflicts = 0;
+        for (UInt32 f = 0; f < kField__MAX; f++)
+        {
+            if (winner.hashes[f] != master.hashes[f]) result.overridden |= 1 << f;
+            // a conflict is two overrides that change the field to different values; an override changes
+            // the field if it differs from the previous winner, even if it restores the master value
+            UInt32 previous = master.hashes[f];
+            UInt32 changes = 0;
+            for (UInt32 i = 1; i < result.count && changes < 2; i++)
+            {
+                UInt32 hash = versions[order[result.first + i]].hashes[f];
+                if (hash != previous) changes++;
+                previous = hash;
+            }
+            if (changes > 1) result.conflicts |= 1 << f;
+        }
+    }
+}
+DWORD WINAPI MyFormConflictTracker::WorkerThread(LPVOID param)
+{
+    Job* job = (Job*)param;
+    job->tracker->Analyze(job->firstGroup,job->lastGroup);
+    return 0;
+}
+SInt32 MyFormConflictTracker::Report(const char* path)
+{
+    TraceScope trace("ReportConflicts","MyForm",versions.size());
+    UInt64 start = PerfTicks();
+
+    // group versions by formID, keeping load order within each group, and keep only overridden forms
+    order.resize(versions.size());
+    std::vector<std::pair<UInt32,UInt32> > keys(versions.size());
+    for (UInt32 i = 0; i < versions.size(); i++) keys[i] = std::make_pair(versions[i].formID,i);
+    std::sort(keys.begin(),keys.end());
+    results.clear();
+    for (UInt32 i = 0; i < keys.size();)
+    {
+        UInt32 j = i;
+        for (; j < keys.size() && keys[j].first == keys[i].first; j++) order[j] = keys[j].second;
+        if (j - i > 1)
+        {
+            Result result = { i, j - i, 0, 0 };
+            results.push_back(result);
+        }
+        i = j;
+    }
+
+    // analyze groups on worker threads
+    UInt32 threadCount = threads;
+    if (!threadCount)
+    {
+        SYSTEM_INFO info;
+        GetSystemInfo(&info);
+        threadCount = info.dwNumberOfProcessors;
+    }
+    if (threadCount > kMaxThreads) threadCount = kMaxThreads;
+    if (threadCount > results.size()) threadCount = results.size() ? results.size() : 1;
+    Job jobs[kMaxThreads];
+    HANDLE handles[kMaxThreads];
+    UInt32 started = 0;
+    for (UInt32 t = 0; t < threadCount; t++)
+    {
+        jobs[t].tracker = this;
+        jobs[t].firstGroup = results.size() * t / threadCount;
+        jobs[t].lastGroup = results.size() * (t + 1) / threadCount;
+        handles[started] = CreateThread(NULL,0,&WorkerThread,&jobs[t],0,NULL);
+        if (handles[started]) started++;
+        else Analyze(jobs[t].firstGroup,jobs[t].lastGroup); // fall back to analyzing on this thread
+    }
+    if (started) WaitForMultipleObjects(started,handles,TRUE,INFINITE);
+    for (UInt32 t = 0; t < started; t++) CloseHandle(handles[t]);
+    UInt64 analyzeTicks = PerfTicks() - start;
+
+    // write report
+    FILE* file = 0;
+    if (fopen_s(&file,path,"w") != 0 || !file)
+    {
+        _ERROR("Could not open conflict report '%s'",path);
+        return -1;
+    }
+    setvbuf(file,NULL,_IOFBF,0x10000);
+    fprintf(file,"# %i MyForm record versions from %i files, %i overridden forms\n",versions.size(),fileNames.size(),results.size());
+    fprintf(file,"# formID editorID: field* (* = conflict): file list in load order, changed files marked +\n");
+    SInt32 conflicting = 0;
+    for (UInt32 g = 0; g < results.size(); g++)
+    {
+        const Result& result = results[g];
+        if (!result.overridden && !result.conflicts) continue; // identical overrides
+        if (result.conflicts) conflicting++;
+        const Version& master = versions[order[result.first]];
+        TESForm* const* forms = 0;
+        const char* editorID = g_myFormIndex.FindRange(master.formID,master.formID,forms) ? g_myFormEditorIDs.EditorID((MyForm*)forms[0]) : "";
+        fprintf(file,"%08X '%s':",master.formID,editorID);
+        for (UInt32 f = 0; f < kField__MAX; f++)
+        {
+            if (!((result.overridden | result.conflicts) & (1 << f))) continue;
+            fprintf(file," %s%s [%s",kFieldNames[f],(result.conflicts & (1 << f)) ? "*" : "",fileNames[master.fileIndex]);
+            for (UInt32 i = 1; i < result.count; i++)
+            {
+                const Version& version = versions[order[result.first + i]];
+                const Version& previous = versions[order[result.first + i - 1]];
+                fprintf(file,", %s%s",version.hashes[f] != previous.hashes[f] ? "+" : "",fileNames[version.fileIndex]);
+            }
+            fprintf(file,"]");
+        }
+        fprintf(file,"\n");
+    }
+    bool success = !ferror(file);
+    fclose(file);
+    _MESSAGE("Wrote conflict report for %i overridden MyForms (%i with conflicts) to '%s', analysis took %.3f ms on %i threads",
+        results.size(), conflicting, path, PerfTicksToMS(analyzeTicks), started ? started : 1);
+    return success ? conflicting : -1;
+}
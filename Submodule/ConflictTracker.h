@@ -0,0 +1,82 @@
+/*
+    Load order conflict detection for MyForms
+
+    When several plugins override the same MyForm, each override is loaded over the previous one, and the
+    last one wins.  In tool mode (enabled in Settings.ini), every record version loaded is recorded here,
+    as the formID, the index of the source file, and a 32-bit hash of each field - so memory per version
+    is fixed and small, no matter how large the field values are.  Field values themselves are not kept.
+
+    On request, versions are grouped by formID and each group is analyzed on a pool of worker threads.
+    For each field, the analysis determines whether it was overridden (the final value differs from the
+    first file's value), and whether it is in conflict (two or more overriding files set different values,
+    so the load order decides which wins).  A file changes a field if its value differs from the value
+    that was winning before it loaded, so a file that restores the master value over another override
+    is a change too.  The results are written as a compact text report.
+*/
+#pragma once
+
+#include <vector>
+
+class   MyForm;             // Submodule/MyForm.h
+class   TESFile;            // COEF/API/TESFiles/TESFile.h
+
+class MyFormConflictTracker
+{
+public:
+    enum Fields
+    {
+        kField_EditorID     = 0,
+        kField_Name,
+        kField_Description, // CS only; in the game descriptions are not resident, and are not compared
+        kField_Icon,
+        kField_Value,
+        kField_Weight,
+        kField_ExtraData,
+        kField__MAX
+    };
+
+    // members
+    bool                enabled;    // record versions while loading
+    UInt32              threads;    // worker threads for analysis, or zero for one per processor
+
+    // methods
+    void                Record(MyForm* form, TESFile& file);    // records a loaded version of form, called at the end of MyForm::LoadForm
+    SInt32              Report(const char* path);   // analyzes all recorded versions & writes report, returns number of forms with conflicts or -1 on error
+    UInt32              MemoryUsage();              // approximate heap bytes used by recorded versions
+
+    // constructor, destructor
+    MyFormConflictTracker();
+    ~MyFormConflictTracker();
+
+private:
+    struct Version  // versions are stored in load order
+    {
+        UInt32      formID;
+        UInt16      fileIndex;  // index into fileNames
+        UInt16      pad06;
+        UInt32      hashes[kField__MAX];
+    };
+    struct Result
+    {
+        UInt32      first;      // index of first version of group
+        UInt32      count;      // number of versions in group
+        UInt32      overridden; // bit mask of fields
+        UInt32      conflicts;  // bit mask of fields
+    };
+    struct Job
+    {
+        MyFormConflictTracker*  tracker;
+        UInt32                  firstGroup, lastGroup;  // range of groups to analyze, [first, last)
+    };
+
+    static DWORD WINAPI     WorkerThread(LPVOID param);
+    void                    Analyze(UInt32 firstGroup, UInt32 lastGroup);
+
+    std::vector<Version>        versions;   // in load order
+    std::vector<char*>          fileNames;  // copies, owned & freed by the tracker, indexed by Version::fileIndex
+    std::vector<UInt32>         order;      // version indices, grouped by formID in load order within each group
+    std::vector<Result>         results;    // one per group with more than one version
+};
+
+// global conflict tracker
+extern MyFormConflictTracker g_myFormConflicts;
@@ -0,0 +1,222 @@
+#include "Submodule/EditorIDIndex.h"
+#include "Submodule/MyForm.h"
+#include "Submodule/Timing.h"
+
+#include <algorithm>
+
+static const UInt32 kEmptySlot      = 0xFFFFFFFF;
+static const UInt32 kBucketSize     = 4;        // average number of keys per bucket
+static const UInt32 kMaxSeed        = 0x10000;  // seeds to try per bucket before enlarging the table
+static const UInt32 kMaxGrowth      = 3;        // times the table is doubled before all entries are left unplaced
+static const UInt32 kMinOverflow    = 0x20;     // overflow entries tolerated before a rebuild, at minimum
+
+/*--------------------------------------------------------------------------------------------*/
+MyFormEditorIDIndex g_myFormEditorIDs;
+
+MyFormEditorIDIndex::MyFormEditorIDIndex()
+: builtCount(0), unplacedEnd(0), overflowStart(0), nextSequence(0), stale(false)
+{
+}
+UInt32 MyFormEditorIDIndex::Hash(const char* editorID)
+{
+    // FNV-1a over lowercase characters
+    UInt32 hash = 0x811C9DC5;
+    for (const unsigned char* c = (const unsigned char*)editorID; *c; c++) hash = (hash ^ (UInt32)tolower(*c)) * 0x01000193;
+    return hash;
+}
+UInt32 MyFormEditorIDIndex::Slot(UInt32 hash, UInt32 seed, UInt32 tableSize)
+{
+    // mix hash with bucket seed (murmur3 finalizer), so each seed gives an independent slot assignment
+    UInt32 x = hash ^ (seed * 0x9E3779B9);
+    x ^= x >> 16; x *= 0x85EBCA6B;
+    x ^= x >> 13; x *= 0xC2B2AE35;
+    x ^= x >> 16;
+    return x % tableSize;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// maintenance
+void MyFormEditorIDIndex::Add(MyForm* form, const char* editorID)
+{
+    Remove(form); // drop any previous editorID
+    if (!editorID || !*editorID) return;
+    Entry entry = { form, Hash(editorID), strings.size(), nextSequence++ };
+    strings.insert(strings.end(), editorID, editorID + strlen(editorID) + 1);
+    entryIndex[form] = entries.size();
+    entries.push_back(entry);
+}
+void MyFormEditorIDIndex::Remove(MyForm* form)
+{
+    std::tr1::unordered_map<MyForm*,UInt32>::iterator it = entryIndex.find(form);
+    if (it == entryIndex.end()) return;
+    UInt32 index = it->second;
+    Entry& entry = entries[index];
+    entry.form = 0;   // entry & string are dropped on the next rebuild
+    entryIndex.erase(it);
+    if (index >= unplacedEnd) return;  // overflow entries shadow nothing that isn't searched anyway
+
+    // a removed table or unplaced entry may have shadowed an older form with the same EditorID
+    for (UInt32 i = unplacedEnd; i < overflowStart && !stale; i++)
+    {
+        stale = entries[i].form && entries[i].hash == entry.hash && _stricmp(&strings[entries[i].offset],&strings[entry.offset]) == 0;
+    }
+}
+void MyFormEditorIDIndex::Build()
+{
+    UInt64 buildStart = PerfTicks();
+
+    // order live entries by hash, with later entries first among equal hashes.  The most recent entry for each
+    // hash goes in the table; later ones are unplaced if their EditorID differs (no seed can separate equal
+    // hashes), or shadowed if it is the same.
+    std::vector<std::pair<UInt64,UInt32> > order;   // (hash:~sequence, index)
+    order.reserve(entryIndex.size());
+    for (UInt32 i = 0; i < entries.size(); i++)
+    {
+        if (entries[i].form) order.push_back(std::make_pair(((UInt64)entries[i].hash << 32) | ~entries[i].sequence,i));
+    }
+    std::sort(order.begin(),order.end());
+    std::vector<UInt32> placed, unplaced, shadowed;
+    placed.reserve(order.size());
+    for (UInt32 i = 0, group = 0; i < order.size(); i++)
+    {
+        if (i == 0 || (order[i].first >> 32) != (order[i-1].first >> 32)) group = i;    // first entry with this hash
+        UInt32 index = order[i].second;
+        const char* editorID = &strings[entries[index].offset];
+        bool duplicate = false;
+        for (UInt32 j = group; j < i && !duplicate; j++)
+        {
+            duplicate = _stricmp(&strings[entries[order[j].second].offset],editorID) == 0;
+        }
+        if (duplicate) shadowed.push_back(index);
+        else if (i != group) unplaced.push_back(index);
+        else placed.push_back(index);
+    }
+    std::vector<Entry> newEntries;
+    std::vector<char> newStrings;
+    newEntries.reserve(order.size());
+    newStrings.reserve(strings.size());
+    entryIndex.clear();
+    std::vector<UInt32>* regions[3] = { &placed, &unplaced, &shadowed };
+    for (UInt32 r = 0; r < 3; r++)
+    {
+        for (UInt32 i = 0; i < regions[r]->size(); i++)
+        {
+            Entry entry = entries[(*regions[r])[i]];
+            const char* editorID = &strings[entry.offset];
+            entry.offset = newStrings.size();
+            newStrings.insert(newStrings.end(), editorID, editorID + strlen(editorID) + 1);
+            entryIndex[entry.form] = newEntries.size();
+            newEntries.push_back(entry);
+        }
+    }
+    entries.swap(newEntries);
+    strings.swap(newStrings);
+    builtCount = placed.size();
+    unplacedEnd = builtCount + unplaced.size();
+    overflowStart = entries.size();
+    stale = false;
+
+    // group entries into buckets, and place the largest buckets first while the table is mostly empty
+    UInt32 count = builtCount;
+    UInt32 bucketCount = count / kBucketSize + 1;
+    std::vector<std::pair<UInt32,UInt32> > bucketOrder(bucketCount);    // (size, bucket)
+    std::vector<UInt32> bucketStart(bucketCount + 1, 0), members(count);
+    for (UInt32 i = 0; i < count; i++) bucketStart[entries[i].hash % bucketCount + 1]++;
+    for (UInt32 b = 0; b < bucketCount; b++)
+    {
+        bucketOrder[b] = std::make_pair(bucketStart[b+1],b);
+        bucketStart[b+1] += bucketStart[b];
+    }
+    std::vector<UInt32> fill(bucketStart.begin(), bucketStart.end() - 1);
+    for (UInt32 i = 0; i < count; i++) members[fill[entries[i].hash % bucketCount]++] = i;
+    std::sort(bucketOrder.rbegin(),bucketOrder.rend());
+
+    // find a seed for each bucket; in the unlikely event that a bucket can't be placed, retry with a larger table
+    UInt32 tableSize = count + count / 4 + 1;
+    bool built = false;
+    for (UInt32 growth = 0; !built && growth <= kMaxGrowth; growth++, tableSize *= 2)
+    {
+        seeds.assign(bucketCount, 0);
+        slots.assign(tableSize, kEmptySlot);
+        built = true;
+        for (UInt32 k = 0; k < bucketCount && built && bucketOrder[k].first; k++)
+        {
+            UInt32 b = bucketOrder[k].second;
+            UInt32 seed = 0;
+            for (; seed < kMaxSeed; seed++)
+            {
+                UInt32 m = bucketStart[b];
+                for (; m < bucketStart[b+1]; m++)
+                {
+                    UInt32 slot = Slot(entries[members[m]].hash,seed,tableSize);
+                    if (slots[slot] != kEmptySlot) break;
+                    slots[slot] = members[m];   // claim tentatively, so members of this bucket don't collide
+                }
+                if (m == bucketStart[b+1]) break;   // all members placed
+                while (m-- > bucketStart[b]) slots[Slot(entries[members[m]].hash,seed,tableSize)] = kEmptySlot; // undo
+            }
+            if (seed < kMaxSeed) seeds[b] = seed;
+            else built = false;
+        }
+    }
+    if (!built)
+    {
+        // all entries are searched linearly, until the next rebuild
+        _WARNING("EditorID index table could not be built; %i MyForms will be searched linearly",count);
+        seeds.clear();
+        slots.clear();
+        builtCount = 0;
+    }
+    _VMESSAGE("Built EditorID index of %i MyForms (%i slots, %i unplaced, %i shadowed) in %.3f ms",
+        builtCount,slots.size(),unplacedEnd - builtCount,overflowStart - unplacedEnd,PerfTicksToMS(PerfTicks() - buildStart));
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// queries
+MyForm* MyFormEditorIDIndex::Lookup(const char* editorID)
+{
+    if (!editorID || !*editorID) return 0;
+    UInt32 overflow = entries.size() - overflowStart;
+    if (stale || (overflow > kMinOverflow && overflow > unplacedEnd / 8)) Build();
+    UInt32 hash = Hash(editorID);
+
+    // search overflow entries first, newest first, since they take precedence over the table
+    for (UInt32 i = entries.size(); i-- > overflowStart;)
+    {
+        const Entry& entry = entries[i];
+        if (entry.form && entry.hash == hash && _stricmp(&strings[entry.offset],editorID) == 0) return entry.form;
+    }
+
+    // probe table
+    if (builtCount)
+    {
+        UInt32 i = slots[Slot(hash, seeds[hash % seeds.size()], slots.size())];
+        const Entry* entry = (i == kEmptySlot) ? 0 : &entries[i];
+        if (entry && entry->hash == hash && _stricmp(&strings[entry->offset],editorID) == 0) return entry->form;
+    }
+
+    // search unplaced entries; shadowed entries are never found
+    for (UInt32 i = builtCount; i < unplacedEnd; i++)
+    {
+        const Entry& entry = entries[i];
+        if (entry.form && entry.hash == hash && _stricmp(&strings[entry.offset],editorID) == 0) return entry.form;
+    }
+    return 0;
+}
+const char* MyFormEditorIDIndex::EditorID(MyForm* form)
+{
+    // the returned string is only valid until the next form is added to the index
+    std::tr1::unordered_map<MyForm*,UInt32>::iterator it = entryIndex.find(form);
+    return (it == entryIndex.end()) ? "" : &strings[entries[it->second].offset];
+}
+UInt32 MyFormEditorIDIndex::Count()
+{
+    return entryIndex.size();
+}
+UInt32 MyFormEditorIDIndex::MemoryUsage()
+{
+    // vector capacities are exact; the entry map is estimated as a bucket array plus one node
+    // (key, value & two links) per element
+    return entries.capacity() * sizeof(Entry) + strings.capacity() + seeds.capacity() * sizeof(UInt32) + slots.capacity() * sizeof(UInt32)
+        + entryIndex.bucket_count() * sizeof(void*) + entryIndex.size() * (sizeof(MyForm*) + sizeof(UInt32) + 2 * sizeof(void*));
+}
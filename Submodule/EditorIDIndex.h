@@ -0,0 +1,75 @@
+/*
+    EditorID index of MyForms
+
+    Script commands resolve MyForms by EditorID through this index instead of searching the form list.
+    The game does not keep EditorIDs for most forms, so the index keeps its own copy of each EditorID,
+    captured when the EDID chunk is loaded (and, in the CS, when the working copy edited in a form's dialog
+    is copied back onto the listed form).
+    Lookups are case insensitive, like all EditorID comparisons in the engine.
+
+    The index is stored as a minimal perfect hash table built with the 'hash and displace' method:
+    -   keys are hashed once, and split into buckets of ~4 keys each
+    -   each bucket is assigned a seed, chosen when the table is built, so that all keys in the bucket
+        land on distinct free slots of the table when their hash is mixed with the seed
+    -   a lookup hashes the key, reads one seed and one slot, and compares one string
+    Building the table is linear in the number of EditorIDs.  It is built on the first lookup after
+    loading (so it is not rebuilt repeatedly while records load), and forms added afterwards go to a
+    short overflow list that is searched linearly, until it grows large enough to warrant a rebuild.
+
+    Keys that can't be separated by any seed are kept out of the table: distinct EditorIDs with the same
+    32-bit hash are 'unplaced' entries, searched linearly after the table, and the table is enlarged only
+    a few times before all entries are left unplaced.  If two forms share an EditorID, the one added most
+    recently is found; the older one is kept as a 'shadowed' entry, and is found again if the newer form
+    is removed.
+*/
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+
+class   MyForm;             // Submodule/MyForm.h
+
+class MyFormEditorIDIndex
+{
+public:
+    // maintenance, called by MyForm
+    void                Add(MyForm* form, const char* editorID);    // (re)indexes form under editorID, or removes it if editorID is empty
+    void                Remove(MyForm* form);
+
+    // queries
+    MyForm*             Lookup(const char* editorID);   // returns the form with the specified EditorID, or null
+    const char*         EditorID(MyForm* form);         // returns the indexed EditorID of form, or an empty string
+    UInt32              Count();                        // number of indexed forms
+    UInt32              MemoryUsage();                  // approximate heap bytes used by the index
+
+    // constructor
+    MyFormEditorIDIndex();
+
+private:
+    struct Entry
+    {
+        MyForm*     form;       // zero if form was removed or re-indexed
+        UInt32      hash;       // case insensitive hash of editorID
+        UInt32      offset;     // offset of editorID in string pool
+        UInt32      sequence;   // order in which entries were added, to resolve duplicate EditorIDs
+    };
+
+    static UInt32       Hash(const char* editorID);
+    static UInt32       Slot(UInt32 hash, UInt32 seed, UInt32 tableSize);
+    void                Build();    // rebuilds the perfect hash table from all live entries
+
+    std::vector<Entry>                      entries;    // entries [0, builtCount) are in the table, [builtCount, unplacedEnd) are unplaced,
+                                                        // [unplacedEnd, overflowStart) are shadowed, and the rest are overflow
+    std::vector<char>                       strings;    // pool of null-terminated EditorIDs
+    std::tr1::unordered_map<MyForm*,UInt32> entryIndex; // live entry for each indexed form
+    std::vector<UInt32>                     seeds;      // displacement seed for each bucket
+    std::vector<UInt32>                     slots;      // entry index for each slot, or kEmptySlot
+    UInt32                                  builtCount; // number of entries covered by the table
+    UInt32                                  unplacedEnd;
+    UInt32                                  overflowStart;
+    UInt32                                  nextSequence;
+    bool                                    stale;      // a shadowed entry must be restored by a rebuild
+};
+
+// global EditorID index
+extern MyFormEditorIDIndex g_myFormEditorIDs;
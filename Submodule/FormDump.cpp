@@ -0,0 +1,152 @@
+#include "Submodule/FormDump.h"
+#include "Submodule/MyForm.h"
+#include "Submodule/WriteBuffer.h"
+#include "Submodule/EditorIDIndex.h"
+#include "Submodule/Timing.h"
+#include "Submodule/Trace.h"
+
+/*--------------------------------------------------------------------------------------------*/
+MyFormDump g_myFormDump;
+
+MyFormDump::MyFormDump()
+: json(false), reported(true), status(kStatus_Idle), writeTicks(0)
+{
+    path[0] = 0;
+}
+UInt32 MyFormDump::AddString(const char* string)
+{
+    UInt32 offset = strings.size();
+    if (!string) string = "";
+    strings.insert(strings.end(), string, string + strlen(string) + 1);
+    return offset;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// main thread
+bool MyFormDump::Start(bool asJson)
+{
+    if (status == kStatus_Running) return false;
+    GetStatus(); // report previous dump, if it hasn't been yet
+    TraceScope trace("DumpMyForms","MyForm");
+    UInt64 captureStart = PerfTicks();
+
+    // capture - buffers keep their capacity from previous dumps, so this rarely allocates
+    rows.clear();
+    strings.clear();
+    BSSimpleList<TESForm*>& formList = MyForm::extendedForm.FormList();
+    for (BSSimpleList<TESForm*>::Node* node = &formList.firstNode; node && node->data; node = node->next)
+    {
+        MyForm* myform = (MyForm*)node->data;
+        Row row;
+        row.formID = myform->formID;
+        row.formType = myform->formType;
+        row.weight = myform->weight;
+        row.goldValue = myform->goldValue;
+        row.extraData = g_extraDataWrites.Read(myform); // include staged writes
+        row.editorID = AddString(g_myFormEditorIDs.EditorID(myform)); // the game doesn't keep EditorIDs itself
+        row.name = AddString(myform->name.c_str());
+        row.icon = AddString(myform->texturePath.c_str());
+        rows.push_back(row);
+    }
+    json = asJson;
+    sprintf_s(path,sizeof(path),"Data\\obse\\plugins\\" SOLUTIONNAME "\\MyForms.%s",json ? "json" : "csv");
+    double captureUS = PerfTicksToUS(PerfTicks() - captureStart);
+    _MESSAGE("Captured %i MyForms for dump in %.1f us (%.1f us per 1000 forms)",
+        rows.size(), captureUS, rows.size() ? captureUS * 1000 / rows.size() : 0.0);
+
+    // hand buffers over to writer thread
+    reported = false;
+    InterlockedExchange(&status,kStatus_Running);
+    HANDLE thread = CreateThread(NULL,0,&WriterThread,this,0,NULL);
+    if (!thread)
+    {
+        _ERROR("Could not start MyForm dump thread (error %i)",GetLastError());
+        InterlockedExchange(&status,kStatus_Failed);
+        reported = true;
+        return false;
+    }
+    CloseHandle(thread);
+    return true;
+}
+MyFormDump::Status MyFormDump::GetStatus()
+{
+    Status current = (Status)status;
+    if (current == kStatus_Running || reported) return current;
+    if (current == kStatus_Done) _MESSAGE("Dumped %i MyForms to '%s' in %.3f ms",rows.size(),path,PerfTicksToMS(writeTicks));
+    else _ERROR("Could not write MyForm dump to '%s'",path);
+    reported = true;
+    return current;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// writer thread
+DWORD WINAPI MyFormDump::WriterThread(LPVOID param)
+{
+    MyFormDump* dump = (MyFormDump*)param;
+    UInt64 writeStart = PerfTicks();
+    bool success = dump->Write();
+    dump->writeTicks = PerfTicks() - writeStart;
+    InterlockedExchange(&dump->status,success ? kStatus_Done : kStatus_Failed); // full barrier, publishes writeTicks
+    return 0;
+}
+// unicode code points for bytes 0x80-0x9F in the game's codepage (cp1252); the rest of the upper half
+// matches Latin-1.  The five bytes cp1252 leaves undefined map to the C1 controls, as on Windows.
+static const UInt16 kCP1252High[0x20] =
+{
+    0x20AC, 0x0081, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021, 0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x008D, 0x017D, 0x008F,
+    0x0090, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014, 0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x009D, 0x017E, 0x0178,
+};
+// writes a string field, quoted & escaped for CSV or JSON
+static void WriteQuoted(FILE* file, const char* string, bool json)
+{
+    fputc('"',file);
+    for (const char* c = string; *c; c++)
+    {
+        if (json)
+        {
+            // control characters & bytes above 0x7F (cp1252, which would not be valid UTF-8) as \uXXXX
+            unsigned char byte = *c;
+            if (*c == '"' || *c == '\\') fputc('\\',file);
+            else if (byte < 0x20 || byte >= 0xA0) { fprintf(file,"\\u%04x",byte); continue; }
+            else if (byte >= 0x80) { fprintf(file,"\\u%04x",kCP1252High[byte - 0x80]); continue; }
+        }
+        else if (*c == '"') fputc('"',file); // CSV escapes quotes by doubling them
+        fputc(*c,file);
+    }
+    fputc('"',file);
+}
+bool MyFormDump::Write()
+{
+    FILE* file = 0;
+    if (fopen_s(&file,path,"w") != 0 || !file) return false;
+    setvbuf(file,NULL,_IOFBF,0x10000);
+    if (json) fprintf(file,"[");
+    else fprintf(file,"formID,formType,editorID,name,icon,weight,value,extraData\n");
+    for (UInt32 i = 0; i < rows.size(); i++)
+    {
+        const Row& row = rows[i];
+        if (json)
+        {
+            fprintf(file,"%s\n{\"formID\":\"%08X\",\"formType\":%i,\"editorID\":",i ? "," : "",row.formID,row.formType);
+            WriteQuoted(file,&strings[row.editorID],true);
+            fprintf(file,",\"name\":");
+            WriteQuoted(file,&strings[row.name],true);
+            fprintf(file,",\"icon\":");
+            WriteQuoted(file,&strings[row.icon],true);
+            fprintf(file,",\"weight\":%f,\"value\":%i,\"extraData\":%i}",row.weight,row.goldValue,row.extraData);
+        }
+        else
+        {
+            fprintf(file,"%08X,%i,",row.formID,row.formType);
+            WriteQuoted(file,&strings[row.editorID],false);
+            fputc(',',file);
+            WriteQuoted(file,&strings[row.name],false);
+            fputc(',',file);
+            WriteQuoted(file,&strings[row.icon],false);
+            fprintf(file,",%f,%i,%i\n",row.weight,row.goldValue,row.extraData);
+        }
+    }
+    if (json) fprintf(file,"\n]\n");
+    bool success = !ferror(file);
+    return fclose(file) == 0 && success;
+}
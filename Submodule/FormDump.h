@@ -0,0 +1,64 @@
+/*
+    Asynchronous dump of all MyForms to a file
+
+    ListMyForms formats and logs every form on the calling thread.  A dump instead captures the minimal
+    per-form data on the main thread, into a contiguous row array and a string pool, and hands it to a
+    background thread that formats it as CSV or JSON and writes it to disk.  The caller only pays for
+    the capture, which is a single pass over the form list with no formatting or I/O.
+
+    Only one dump runs at a time.  The capture buffers belong to the writer thread until it finishes,
+    and are reused by the next dump.  Completion is reported through GetStatus(), which is polled (via
+    SubmoduleInterface::MyFormDumpStatus) by the DumpStatus console command and the GetMyFormDumpStatus
+    script command; the writer thread itself never touches forms or the output log.
+*/
+#pragma once
+
+#include <vector>
+
+class MyFormDump
+{
+public:
+    enum Status
+    {
+        kStatus_Idle        = 0,    // no dump started yet
+        kStatus_Running     = 1,    // writer thread is busy
+        kStatus_Done        = 2,    // last dump was written successfully
+        kStatus_Failed      = -1,   // last dump could not be written
+    };
+
+    // main thread only
+    bool                Start(bool json);   // captures all MyForms & starts writing them, returns false if a dump is already running
+    Status              GetStatus();        // returns status of the last dump, reporting its result to the log once
+
+    // constructor
+    MyFormDump();
+
+private:
+    struct Row
+    {
+        UInt32      formID;
+        UInt8       formType;
+        UInt8       pad05[3];
+        float       weight;
+        SInt32      goldValue;
+        UInt32      extraData;
+        UInt32      editorID;   // offsets into string pool
+        UInt32      name;
+        UInt32      icon;
+    };
+
+    UInt32                  AddString(const char* string);  // appends string to pool, returns its offset
+    bool                    Write();    // formats & writes rows to path, on the writer thread
+    static DWORD WINAPI     WriterThread(LPVOID param);
+
+    std::vector<Row>        rows;
+    std::vector<char>       strings;
+    bool                    json;
+    bool                    reported;       // result of the last dump has been logged
+    char                    path[MAX_PATH];
+    volatile LONG           status;
+    UInt64                  writeTicks;     // time taken by the writer thread, set before status changes
+};
+
+// global MyForm dump
+extern MyFormDump g_myFormDump;
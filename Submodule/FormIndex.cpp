@@ -0,0 +1,175 @@
+#include "Submodule/FormIndex.h"
+#include "Submodule/MyForm.h"
+
+#include <algorithm>
+
+/*--------------------------------------------------------------------------------------------*/
+MyFormIndex g_myFormIndex;
+
+MyFormIndex::MyFormIndex()
+: nullCount(0), rebuild(true)
+{
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// maintenance
+void MyFormIndex::Add(MyForm* form)
+{
+    if (rebuild) return;    // the whole index is rebuilt anyway
+    pending.insert(form);
+    if (pending.size() <= kMaxPending) return;
+    pending.clear();    // bulk load
+    rebuild = true;
+}
+void MyFormIndex::Remove(MyForm* form)
+{
+    pending.erase(form);
+    std::tr1::unordered_map<MyForm*,UInt32>::iterator it = keys.find(form);
+    if (it == keys.end()) return;   // not indexed
+    Erase(form,it->second);
+    keys.erase(it);
+}
+void MyFormIndex::Erase(MyForm* form, UInt32 formID)
+{
+    UInt32 i = std::lower_bound(formIDs.begin(),formIDs.end(),formID) - formIDs.begin();
+    for (; i < formIDs.size() && formIDs[i] == formID; i++)
+    {
+        if (forms[i] != form) continue;
+        forms[i] = 0;
+        nullCount++;
+        return;
+    }
+}
+void MyFormIndex::Rebuild()
+{
+    // collect & sort the forms in the FormList, keyed by their current formIDs
+    sortBuffer.clear();
+    BSSimpleList<TESForm*>& formList = MyForm::extendedForm.FormList();
+    for (BSSimpleList<TESForm*>::Node* node = &formList.firstNode; node && node->data; node = node->next)
+    {
+        sortBuffer.push_back(std::make_pair(node->data->formID,node->data));
+    }
+    std::sort(sortBuffer.begin(),sortBuffer.end());
+
+    formIDs.resize(sortBuffer.size());
+    forms.resize(sortBuffer.size());
+    keys.clear();
+    for (UInt32 i = 0; i < sortBuffer.size(); i++)
+    {
+        formIDs[i] = sortBuffer[i].first;
+        forms[i] = sortBuffer[i].second;
+        keys[(MyForm*)forms[i]] = formIDs[i];
+    }
+    pending.clear();
+    nullCount = 0;
+    rebuild = false;
+}
+void MyFormIndex::Refresh()
+{
+    if (rebuild) { Rebuild(); return; }
+
+    if (!pending.empty())
+    {
+        // indexed forms are re-keyed if their formID changed; the others are looked for in the FormList
+        sortBuffer.clear();
+        std::vector<TESForm*> unlisted;
+        for (std::tr1::unordered_set<MyForm*>::iterator it = pending.begin(); it != pending.end(); ++it)
+        {
+            MyForm* form = *it;
+            std::tr1::unordered_map<MyForm*,UInt32>::iterator key = keys.find(form);
+            if (key == keys.end()) unlisted.push_back(form);
+            else if (key->second != form->formID)
+            {
+                Erase(form,key->second);
+                keys.erase(key);
+                sortBuffer.push_back(std::make_pair(form->formID,(TESForm*)form));
+            }
+        }
+        pending.clear();
+        if (!unlisted.empty())
+        {
+            std::sort(unlisted.begin(),unlisted.end());
+            UInt32 found = 0;
+            BSSimpleList<TESForm*>& formList = MyForm::extendedForm.FormList();
+            for (BSSimpleList<TESForm*>::Node* node = &formList.firstNode; node && node->data && found < unlisted.size(); node = node->next)
+            {
+                if (!std::binary_search(unlisted.begin(),unlisted.end(),node->data)) continue;
+                sortBuffer.push_back(std::make_pair(node->data->formID,node->data));
+                found++;
+            }
+        }
+
+        // insert, after any forms with the same formID
+        for (UInt32 i = 0; i < sortBuffer.size(); i++)
+        {
+            UInt32 at = std::upper_bound(formIDs.begin(),formIDs.end(),sortBuffer[i].first) - formIDs.begin();
+            formIDs.insert(formIDs.begin() + at,sortBuffer[i].first);
+            forms.insert(forms.begin() + at,sortBuffer[i].second);
+            keys[(MyForm*)sortBuffer[i].second] = sortBuffer[i].first;
+        }
+    }
+
+    if (nullCount)
+    {
+        // remove null entries in one pass
+        UInt32 count = 0;
+        for (UInt32 i = 0; i < forms.size(); i++)
+        {
+            if (!forms[i]) continue;
+            formIDs[count] = formIDs[i];
+            forms[count] = forms[i];
+            count++;
+        }
+        formIDs.resize(count);
+        forms.resize(count);
+        nullCount = 0;
+    }
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// queries
+UInt32 MyFormIndex::FindRange(UInt32 firstFormID, UInt32 lastFormID, TESForm* const*& result)
+{
+    Refresh();
+    result = 0;
+    if (firstFormID > lastFormID) return 0;
+    UInt32 first = std::lower_bound(formIDs.begin(),formIDs.end(),firstFormID) - formIDs.begin();
+    UInt32 last = std::upper_bound(formIDs.begin() + first,formIDs.end(),lastFormID) - formIDs.begin();
+    if (first >= last) return 0;
+
+    // forms whose formID was changed without notice are re-keyed, and the query repeated
+    bool stale = false;
+    for (UInt32 i = first; i < last; i++)
+    {
+        if (forms[i]->formID == formIDs[i]) continue;
+        pending.insert((MyForm*)forms[i]);
+        stale = true;
+    }
+    if (stale) return FindRange(firstFormID,lastFormID,result);
+
+    result = &forms[first];
+    return last - first;
+}
+UInt32 MyFormIndex::FindModIndex(UInt8 modIndex, TESForm* const*& result)
+{
+    return FindRange((UInt32)modIndex << 24, ((UInt32)modIndex << 24) | 0x00FFFFFF, result);
+}
+bool MyFormIndex::Contains(MyForm* form)
+{
+    Refresh();
+    return keys.find(form) != keys.end();
+}
+UInt32 MyFormIndex::Count()
+{
+    Refresh();
+    return formIDs.size();
+}
+UInt32 MyFormIndex::MemoryUsage()
+{
+    // array capacities are exact; the hash containers are estimated as a bucket array plus one node
+    // (value & two links) per element, which is how the VS2008 TR1 implementation is laid out
+    return formIDs.capacity() * sizeof(UInt32) + forms.capacity() * sizeof(TESForm*)
+        + sortBuffer.capacity() * sizeof(sortBuffer[0])
+        + keys.bucket_count() * sizeof(void*) + keys.size() * (sizeof(std::pair<MyForm*,UInt32>) + 2 * sizeof(void*))
+        + pending.bucket_count() * sizeof(void*) + pending.size() * (sizeof(MyForm*) + 2 * sizeof(void*));
+}
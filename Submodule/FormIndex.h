@@ -0,0 +1,65 @@
+/*
+    Sorted formID index of MyForms
+
+    The FormList maintained by the ExtendedForm component is unordered, so queries by formID range or by
+    mod index would require a full scan.  This index keeps all MyForms sorted by formID, as two parallel
+    arrays - one of formIDs, and one of form pointers - so that binary searches touch only the compact
+    formID array, and the forms in any range are returned as a contiguous slice of the form array.
+
+    The index holds exactly the forms in the FormList: temporary forms created by the CS (e.g. the working
+    copies edited in dialogs) are never in the list, and a form is only listed once its formID has been
+    assigned.  It is maintained incrementally:
+    -   forms are added to a pending set when constructed, loaded (which assigns the formID) or copied onto
+    -   on the next query, pending forms that are already indexed are re-keyed if their formID changed, and
+        the others are looked for in the FormList - the engine lists a form right after loading it, and
+        new forms are at the front of the list, so the walk is short - and inserted with lower_bound if
+        found; pending forms that are not listed (temporaries) are dropped
+    -   destroyed forms are replaced by a null entry, and null entries are removed on the next query
+    While data files load, forms are constructed & loaded in bulk: once the pending set is too large,
+    it is discarded and the next query rebuilds the whole index from the FormList instead.
+    A formID changed by other means is noticed when a query returns the form, which is then re-keyed.
+*/
+#pragma once
+
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+class   TESForm;            // COEF/API/TESForms/TESForm.h
+class   MyForm;             // Submodule/MyForm.h
+
+class MyFormIndex
+{
+public:
+    static const UInt32 kMaxPending = 0x400;    // pending forms, beyond which the index is rebuilt on the next query
+
+    // maintenance, called by MyForm
+    void                Add(MyForm* form);      // form was constructed, loaded or copied onto, and may be (re)listed
+    void                Remove(MyForm* form);
+
+    // queries - returned slices are valid until the next form is created, loaded or destroyed
+    UInt32              FindRange(UInt32 firstFormID, UInt32 lastFormID, TESForm* const*& forms); // forms with formIDs in [first, last], returns count
+    UInt32              FindModIndex(UInt8 modIndex, TESForm* const*& forms);   // forms from the specified mod index, returns count
+    bool                Contains(MyForm* form); // form is in the FormList
+    UInt32              Count();
+    UInt32              MemoryUsage();  // approximate heap bytes used by the index
+
+    // constructor
+    MyFormIndex();
+
+private:
+    void                Refresh();  // merges pending forms & removes null entries, or rebuilds the arrays from the FormList
+    void                Rebuild();
+    void                Erase(MyForm* form, UInt32 formID);    // replaces the entry of an indexed form by a null entry
+
+    std::vector<UInt32>                     formIDs;    // sorted
+    std::vector<TESForm*>                   forms;      // parallel to formIDs, null for destroyed or re-keyed forms
+    std::tr1::unordered_map<MyForm*,UInt32> keys;       // formID under which each indexed form is sorted
+    std::tr1::unordered_set<MyForm*>        pending;    // forms not yet merged into the sorted arrays
+    std::vector<std::pair<UInt32,TESForm*> > sortBuffer; // kept between refreshes, to avoid reallocating
+    UInt32                                  nullCount;  // number of null entries in forms
+    bool                                    rebuild;    // pending set overflowed; the arrays are rebuilt on the next query
+};
+
+// global MyForm index
+extern MyFormIndex g_myFormIndex;
@@ -0,0 +1,219 @@
+#include "Submodule/FormRegistry.h"
+#include "Submodule/Timing.h"
+#include "Submodule/MyForm.h"
+#include "Submodule/MenuRouter.h"
+#include "Components/EventManager.h"
+
+#include "API/CSDialogs/TESDialog.h"
+
+/*--------------------------------------------------------------------------------------------*/
+// Class table
+// Every extended form class defined by this plugin must be listed here to be registered
+static FormClassInfo* s_formClasses[] =
+{
+    &MyForm::classInfo,
+};
+static const UInt32 kFormClassCount = sizeof(s_formClasses) / sizeof(s_formClasses[0]);
+
+// lookup table by form type code, filled in during registration
+static FormClassInfo* s_classesByType[0x100] = {0};
+
+/*--------------------------------------------------------------------------------------------*/
+// vtbl patch plan
+/*
+    Many of the Oblivion classes defined in COEF are incomplete, and COEF does not import methods with
+    unknown signatures (marked '_NOUSE').  The compiler-generated vtbls for new form classes therefore
+    have blank entries, which must be filled in by copying the addresses from the vanilla TESForm vtbl
+    (see notes in the MyForm constructor).
+    The plan below lists the byte offsets of the blank TESForm vtbl entries.  It was generated from the
+    TESForm '_NOUSE' method bitmasks (bit i set => entry at offset 4*i is blank):
+        Game:   { 0x86048400, 0x001E1FC7 }
+        CS:     { 0x090800D0, 0x0F783F8F, 0x00000105 }
+    Storing the offsets directly means patching is a single pass over a short table, with no bit tests.
+*/
+#ifdef OBLIVION
+static const UInt16 TESForm_NoUseOffsets[] =
+{
+    0x028, 0x03C, 0x048, 0x064, 0x068, 0x07C, 0x080, 0x084, 0x088, 0x098,
+    0x09C, 0x0A0, 0x0A4, 0x0A8, 0x0AC, 0x0B0, 0x0C4, 0x0C8, 0x0CC, 0x0D0,
+};
+static const UInt32* const TESForm_vtbl = (const UInt32*)0x00A3BE3C;
+#else
+static const UInt16 TESForm_NoUseOffsets[] =
+{
+    0x010, 0x018, 0x01C, 0x04C, 0x060, 0x06C, 0x080, 0x084, 0x088, 0x08C,
+    0x09C, 0x0A0, 0x0A4, 0x0A8, 0x0AC, 0x0B0, 0x0B4, 0x0CC, 0x0D0, 0x0D4,
+    0x0D8, 0x0E0, 0x0E4, 0x0E8, 0x0EC, 0x100, 0x108, 0x120,
+};
+static const UInt32* const TESForm_vtbl = (const UInt32*)0x0093DA0C;
+#endif
+static const UInt32 kNoUseOffsetCount = sizeof(TESForm_NoUseOffsets) / sizeof(TESForm_NoUseOffsets[0]);
+
+bool FormRegistry_PatchVtbl(FormClassInfo& info)
+{
+    /*
+        Patch the TESForm portion of the vtbl for a form class
+        The vtbl is supplied by the class descriptor, rather than read from a prototype instance, since
+        constructing & destroying a form has side effects (instance statistics, indexes, logging).
+        All blank entries are written under a single page protection change.
+    */
+    UInt32* vtbl = info.vtbl;
+    if (!vtbl) return false;
+    _VMESSAGE("Patching %s TESForm vtbl @ <%p> (%i entries)",info.className,vtbl,kNoUseOffsetCount);
+
+    UInt32* first = vtbl + TESForm_NoUseOffsets[0]/4;
+    UInt32 span = TESForm_NoUseOffsets[kNoUseOffsetCount-1] + 4 - TESForm_NoUseOffsets[0];
+    DWORD oldProtect = 0;
+    bool result = VirtualProtect(first,span,PAGE_EXECUTE_READWRITE,&oldProtect) != 0;
+    if (result)
+    {
+        for (UInt32 i = 0; i < kNoUseOffsetCount; i++) vtbl[TESForm_NoUseOffsets[i]/4] = TESForm_vtbl[TESForm_NoUseOffsets[i]/4];
+        VirtualProtect(first,span,oldProtect,&oldProtect);
+        FlushInstructionCache(GetCurrentProcess(),first,span);
+    }
+    else _ERROR("Could not unprotect %s vtbl @ <%p>",info.className,vtbl);
+    return result;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// FormClassInfo
+FormClassInfo::FormClassInfo(ExtendedForm& form, const char* shortName, const char* className, UInt32 objectSize,
+                    const UInt32* vtbl, CreateFunc create, InitializeFunc initialize, OpenDialogFunc openDialog)
+: extendedForm(form), shortName(shortName), className(className), objectSize(objectSize),
+  vtbl(const_cast<UInt32*>(vtbl)), create(create), initialize(initialize), openDialog(openDialog), menuIdentifier(0),
+  instanceCount(0), loadCount(0), loadTicks(0), loadWarnings(0)
+{
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// CS menu management
+#ifndef OBLIVION
+void FormRegistry_AddMenuItems()
+{
+    // insert a new item into the CS main menu for each class with a dialog
+    HMENU menu = GetMenu(TESDialog::csHandle); // get main CS menu handle
+    menu = GetSubMenu(menu,3);              // get 'World' submenu handle
+    for (UInt32 i = 0; i < kFormClassCount; i++)
+    {
+        FormClassInfo* info = s_formClasses[i];
+        if (!info->menuIdentifier) continue;    // class has no dialog
+        MENUITEMINFO iteminfo;
+        iteminfo.cbSize = sizeof(iteminfo);
+        iteminfo.fMask = MIIM_ID | MIIM_FTYPE | MIIM_STRING;
+        iteminfo.fType = MFT_STRING;
+        char menulabel[0x100];
+        sprintf_s(menulabel,sizeof(menulabel),SOLUTIONNAME " %s ...",info->className);
+        iteminfo.dwTypeData = menulabel;
+        iteminfo.cch = strlen(menulabel);
+        iteminfo.wID = info->menuIdentifier;
+        InsertMenuItem(menu,i,true,&iteminfo); // Insert new entries at top of submenu, in class table order
+    }
+}
+void FormRegistry_OpenDialog(void* param)
+{
+    // MenuRouter handler for the menu item of a form class
+    ((FormClassInfo*)param)->openDialog();
+}
+#endif
+
+/*--------------------------------------------------------------------------------------------*/
+// registration
+void FormRegistry::RegisterAll()
+{
+    _MESSAGE("Registering %i extended form classes ...", kFormClassCount);
+    gLog.Indent();
+
+    for (UInt32 i = 0; i < kFormClassCount; i++)
+    {
+        FormClassInfo* info = s_formClasses[i];
+
+        // register form type with the ExtendedForm COEF component
+        info->extendedForm.Register(info->shortName);
+        s_classesByType[info->extendedForm.FormType()] = info;
+        _VMESSAGE("Registered %s '%s' as form type 0x%02X",info->className,info->shortName,info->extendedForm.FormType());
+
+        // patch vtbl, once per class
+        FormRegistry_PatchVtbl(*info);
+
+        // assign a menu identifier from the range reserved by the MenuRouter, placed by the first form type
+        #ifndef OBLIVION
+        if (i == 0) MenuRouter::PlaceRange(info->extendedForm.FormType());
+        if (info->openDialog)
+        {
+            info->menuIdentifier = MenuRouter::Allocate(&FormRegistry_OpenDialog,info);
+            if (!info->menuIdentifier) _ERROR("Menu identifier range exhausted, no menu item for %s",info->className);
+        }
+        #endif
+
+        // perform class-specific initialization
+        if (info->initialize) info->initialize();
+    }
+
+    #ifndef OBLIVION
+
+    // attempt to add new menu items to the CS
+    // this may fail for newer (v21+) versions of OBSE that load plugins before
+    // the CS main window has been initialized.
+    FormRegistry_AddMenuItems();
+
+    // register CSWindows::InitializeWindows event handler with the EventManager COEF component
+    // this event occurs during startup, after the CS has initialized the main MDI window and menu
+    // items cannot be added to the main CS menu until this event has occurred
+    // older versions of OBSE (<= v20) load plugins *after* this event, meaning it will never be trapped
+    EventManager::CSWindows::InitializeWindows.RegisterCallback(&FormRegistry_AddMenuItems);
+
+    // route WM_COMMAND messages from the new menu items
+    MenuRouter::Attach();
+
+    #endif
+
+    gLog.Outdent();
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// lookup
+UInt32 FormRegistry::ClassCount()
+{
+    return kFormClassCount;
+}
+FormClassInfo* FormRegistry::GetClass(UInt32 index)
+{
+    return (index < kFormClassCount) ? s_formClasses[index] : 0;
+}
+FormClassInfo* FormRegistry::LookupByFormType(UInt8 formType)
+{
+    return s_classesByType[formType];
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// statistics
+void FormRegistry::ReportStatistics()
+{
+    // dumps per-type statistics to the output log, ordered by time spent loading
+    FormClassInfo* sorted[kFormClassCount];
+    memcpy(sorted,s_formClasses,sizeof(sorted));
+    for (UInt32 i = 1; i < kFormClassCount; i++) // insertion sort, the class table is small
+    {
+        FormClassInfo* info = sorted[i];
+        UInt32 j = i;
+        for (; j > 0 && sorted[j-1]->loadTicks < info->loadTicks; j--) sorted[j] = sorted[j-1];
+        sorted[j] = info;
+    }
+
+    _MESSAGE("Extended Form Statistics ...");
+    gLog.Indent();
+    UInt64 totalBytes = 0, totalTicks = 0;
+    for (UInt32 i = 0; i < kFormClassCount; i++)
+    {
+        FormClassInfo* info = sorted[i];
+        UInt64 bytes = (UInt64)info->instanceCount * info->objectSize;
+        double loadMS = PerfTicksToMS(info->loadTicks);
+        _MESSAGE("%s '%s' (%02X): instances=%i, objects=%I64u bytes, records=%u, load=%.3f ms (%.0f records/s), load warnings=%u",
+            info->className, info->shortName, info->extendedForm.FormType(), info->instanceCount, bytes,
+            info->loadCount, loadMS, loadMS > 0 ? info->loadCount * 1000.0 / loadMS : 0.0, info->loadWarnings);
+        totalBytes += bytes;
+        totalTicks += info->loadTicks;
+    }
+    _MESSAGE("Total: objects=%I64u bytes, load=%.3f ms", totalBytes, PerfTicksToMS(totalTicks));
+    gLog.Outdent();
+}
@@ -0,0 +1,75 @@
+/*
+    Registry of extended form classes
+
+    Each new form class defined by this plugin describes itself with a static FormClassInfo object,
+    and lists that object in the class table at the top of FormRegistry.cpp.  FormRegistry::RegisterAll()
+    then performs the one-time setup for every class in a single pass:
+    -   registers the class with the COEF ExtendedForm component, which assigns it a form type code
+    -   patches the class vtbl, which the class supplies directly, so no instance has to be created
+    -   assigns a menu identifier from the range reserved by the MenuRouter (see MenuRouter.h)
+    -   calls the class-specific initialization function, if any
+    In the CS, the registry also owns the menu items for all classes.
+
+    The FormClassInfo object also collects per-type statistics (live instances, memory footprint, time
+    spent loading records), which can be dumped to the output log with FormRegistry::ReportStatistics().
+*/
+#pragma once
+
+#include "Components/ExtendedForm.h"
+
+class   TESForm;            // COEF/API/TESForms/TESForm.h
+
+// Descriptor for a single extended form class
+class FormClassInfo
+{
+public:
+    typedef TESForm* (*CreateFunc)();       // creates a new instance of the class
+    typedef void    (*InitializeFunc)();    // class-specific initialization, called after registration
+    typedef void    (*OpenDialogFunc)();    // opens the CS dialog for the class
+
+    // members - class description
+    ExtendedForm&       extendedForm;       // COEF ExtendedForm component for this class
+    const char*         shortName;          // 4-character record name, must be unique among all plugins
+    const char*         className;          // class name, must be unique within this plugin
+    UInt32              objectSize;         // size of a single instance, for memory statistics
+    UInt32*             vtbl;               // compiler-generated vtbl of the class, patched during registration
+    CreateFunc          create;             // creates a new instance, same function passed to ExtendedForm
+    InitializeFunc      initialize;         // class-specific initialization, may be null
+    OpenDialogFunc      openDialog;         // opens CS dialog, or null if the class has no dialog
+
+    // members - assigned during registration
+    UInt32              menuIdentifier;     // identifier of CS menu item for this class, or zero if none
+
+    // members - per-type statistics
+    SInt32              instanceCount;      // current number of live instances
+    UInt32              loadCount;          // number of records loaded
+    UInt64              loadTicks;          // total time spent in LoadForm, in performance counter ticks
+    UInt32              loadWarnings;       // number of malformed or unexpected chunks encountered while loading
+
+    // constructor
+    FormClassInfo(ExtendedForm& form, const char* shortName, const char* className, UInt32 objectSize,
+                    const UInt32* vtbl, CreateFunc create, InitializeFunc initialize, OpenDialogFunc openDialog);
+
+    // statistics
+    // OnConstruct() and OnDestruct() are called on every construction, so they must remain branch-free
+    inline void         OnConstruct() { ++instanceCount; }
+    inline void         OnDestruct() { --instanceCount; }
+    inline void         OnLoad(UInt64 ticks) { loadCount++; loadTicks += ticks; }
+    inline void         OnLoadWarning() { loadWarnings++; }
+};
+
+// Registry of all extended form classes defined by this plugin
+class FormRegistry
+{
+public:
+    // registration
+    static void                 RegisterAll(); // registers & initializes all classes in the class table
+
+    // lookup
+    static UInt32               ClassCount();
+    static FormClassInfo*       GetClass(UInt32 index);
+    static FormClassInfo*       LookupByFormType(UInt8 formType); // returns null if type is not an extended class from this plugin
+
+    // statistics
+    static void                 ReportStatistics(); // dumps per-type statistics to the output log
+};
@@ -1,11 +1,24 @@
 #include "Submodule/Interface.h"
 #include "Submodule/Version.h"
 #include "Submodule/MyForm.h"
+#include "Submodule/FormRegistry.h"
+#include "Submodule/WriteBuffer.h"
+#include "Submodule/Snapshot.h"
+#include "Submodule/Trace.h"
+#include "Submodule/FormIndex.h"
+#include "Submodule/EditorIDIndex.h"
+#include "Submodule/FormDump.h"
+#include "Submodule/ConflictTracker.h"
+
+// opt-in tracing of individual script command calls, set from Settings.ini during initialization
+bool g_traceCommands = false;
 
 void SubmoduleInterface::ListMyForms()
 {
     // dumps info on all MyForm objects in the extended data handler to the output log
     // the list is accessed using the FormList() method of the MyForm::extendedForm object
+    TraceScope trace("ListMyForms","MyForm");
+    g_extraDataWrites.Commit(); // apply staged writes, so the listing is up to date
     _MESSAGE("Dumping MyForm List ...");
     gLog.Indent();
     for (BSSimpleList<TESForm*>::Node* node = &MyForm::extendedForm.FormList().firstNode; node && node->data; node = node->next)
@@ -21,20 +34,169 @@ void SubmoduleInterface::SetMyFormExtraData(TESForm* form, UInt32 extraData)
 {
     MyForm* myform = dynamic_cast<MyForm*>(form);   // typecast to MyForm
     if (!myform) return; // argument was not a MyForm object
-    _MESSAGE("SetMyFormExtraData ( %08X, %i -> %i )", myform ? myform->formID : 0, myform->extraData, extraData);
-    myform->extraData = extraData;  // set the extraData field on the argument
+    if (g_traceCommands) _MESSAGE("SetMyFormExtraData ( %08X, %i -> %i )", myform->formID, g_extraDataWrites.Latest(myform), extraData);
+    g_extraDataWrites.Write(myform,extraData);  // stage write to the extraData field on the argument
 }
 UInt32 SubmoduleInterface::GetMyFormExtraData(TESForm* form)
 {
     MyForm* myform = dynamic_cast<MyForm*>(form);   // typecast to MyForm
     if (!myform) return 0; // argument was not a MyForm object
-    _MESSAGE("GetMyFormExtraData ( %08X, %i )", myform ? myform->formID : 0, myform->extraData);
-    return myform->extraData; // return the extraData field from the argument
+    UInt32 extraData = g_extraDataWrites.Read(myform); // get the extraData field from the argument
+    if (g_traceCommands) _MESSAGE("GetMyFormExtraData ( %08X, %i )", myform->formID, extraData);
+    return extraData;
 }
 const char* SubmoduleInterface::Description()
 {
-    static char buffer[0x100];
-    sprintf_s(buffer,sizeof(buffer), SOLUTIONNAME ", v%i.%i beta%i", MAJOR_VERSION,MINOR_VERSION,BETA_VERSION);
+    // the description is formatted once, during submodule initialization, so that later calls
+    // from any thread only read the buffer
+    static char buffer[0x100] = {0};
+    if (!buffer[0]) sprintf_s(buffer,sizeof(buffer), SOLUTIONNAME ", v%i.%i beta%i", MAJOR_VERSION,MINOR_VERSION,BETA_VERSION);
     return buffer;
 }
+void SubmoduleInterface::ListFormStatistics()
+{
+    FormRegistry::ReportStatistics();
+}
+
+// direct dispatch handlers - the caller guarantees that the argument is a MyForm
+UInt32 Direct_GetMyFormExtraData(TESForm* form)
+{
+    MyForm* myform = static_cast<MyForm*>(form);
+    UInt32 extraData = g_extraDataWrites.Read(myform);
+    if (g_traceCommands) _MESSAGE("GetMyFormExtraData ( %08X, %i )", myform->formID, extraData);
+    return extraData;
+}
+void Direct_SetMyFormExtraData(TESForm* form, UInt32 extraData)
+{
+    MyForm* myform = static_cast<MyForm*>(form);
+    if (g_traceCommands) _MESSAGE("SetMyFormExtraData ( %08X, %i -> %i )", myform->formID, g_extraDataWrites.Latest(myform), extraData);
+    g_extraDataWrites.Write(myform,extraData);
+}
+UInt32 SubmoduleInterface::CommitMyFormWrites()
+{
+    UInt32 applied = g_extraDataWrites.Commit();
+    g_myFormSnapshots.Publish();    // publish committed state for worker threads, if anything changed
+    return applied;
+}
+UInt32 SubmoduleInterface::GetMyFormsInRange(UInt32 firstFormID, UInt32 lastFormID, TESForm* const*& forms)
+{
+    return g_myFormIndex.FindRange(firstFormID,lastFormID,forms);
+}
+// estimated size of a heap block holding the specified number of bytes: an 8 byte header, rounded up to
+// 8 byte granularity (typical of both the Win32 heap and the game's own allocator)
+inline UInt32 HeapBlockSize(UInt32 bytes) { return (bytes + 8 + 7) & ~7; }
+void SubmoduleInterface::GetMyFormMemoryUsage(MyFormMemoryUsage& usage)
+{
+    // walks the form list once; strings are measured by their stored length, so this is cheap enough to
+    // call periodically.  Descriptions are only resident in the CS - the game loads them on demand into
+    // a shared buffer, which is not counted.
+    TraceScope trace("GetMyFormMemoryUsage","MyForm");
+    memset(&usage,0,sizeof(usage));
+    UInt32 heapBlocks = 0, heapBytes = 0;   // blocks allocated separately from the form objects
+    BSSimpleList<TESForm*>& formList = MyForm::extendedForm.FormList();
+    for (BSSimpleList<TESForm*>::Node* node = &formList.firstNode; node && node->data; node = node->next)
+    {
+        MyForm* myform = (MyForm*)node->data;
+        usage.formCount++;
+        if (node != &formList.firstNode) usage.listNodeBytes += sizeof(*node);  // first node is embedded in the list
+        UInt32 strings[4] = { myform->name.Size(), myform->texturePath.Size(), 0, 0 };
+        #ifndef OBLIVION
+        const char* editorID = myform->GetEditorID();
+        const char* description = myform->GetDescription(myform,Swap32('DESC'));
+        strings[2] = (editorID && *editorID) ? strlen(editorID) : 0;
+        strings[3] = (description && *description) ? strlen(description) : 0;
+        #endif
+        for (UInt32 i = 0; i < 4; i++)
+        {
+            if (!strings[i]) continue;  // empty strings have no buffer
+            usage.stringBytes += strings[i] + 1;
+            usage.overheadBytes += HeapBlockSize(strings[i] + 1) - (strings[i] + 1);
+        }
+    }
+    usage.objectBytes = usage.formCount * MyForm::classInfo.objectSize;
+    usage.overheadBytes += usage.formCount * (HeapBlockSize(MyForm::classInfo.objectSize) - MyForm::classInfo.objectSize);
+    if (usage.formCount > 1) usage.overheadBytes += (usage.formCount - 1) * (HeapBlockSize(sizeof(*formList.firstNode.next)) - sizeof(*formList.firstNode.next));
+    usage.indexBytes = g_myFormIndex.MemoryUsage() + g_myFormEditorIDs.MemoryUsage() + g_extraDataWrites.MemoryUsage() + g_myFormSnapshots.MemoryUsage()
+        + g_myFormConflicts.MemoryUsage();
+    usage.totalBytes = usage.objectBytes + usage.stringBytes + usage.listNodeBytes + usage.indexBytes + usage.overheadBytes;
+}
+TESForm* SubmoduleInterface::GetMyFormByEditorID(const char* editorID)
+{
+    return g_myFormEditorIDs.Lookup(editorID);
+}
+UInt32 SubmoduleInterface::ApplyMyFormExtraData(const UInt32* formIDs, const UInt32* extraData, UInt32 count)
+{
+    // merge sorted formIDs with the sorted formID index; staged writes to the affected forms are discarded,
+    // since they would otherwise overwrite the applied values on the next commit
+    TESForm* const* forms = 0;
+    UInt32 formCount = g_myFormIndex.FindRange(0,0xFFFFFFFF,forms);
+    UInt32 applied = 0;
+    for (UInt32 i = 0, j = 0; i < count && j < formCount;)
+    {
+        if (forms[j]->formID < formIDs[i]) j++;
+        else if (formIDs[i] < forms[j]->formID) i++;
+        else
+        {
+            MyForm* myform = (MyForm*)forms[j];
+            g_extraDataWrites.Discard(myform);
+            AtomicStore(myform->extraData,extraData[i]);
+            applied++; i++; j++;
+        }
+    }
+    if (applied) g_myFormSnapshots.MarkChanged();
+    g_myFormSnapshots.Publish();    // publish loaded state for worker threads, if anything changed
+    return applied;
+}
+void SubmoduleInterface::AggregateMyForms(TESForm* const* forms, const SInt32* counts, UInt32 count, MyFormAggregate& totals,
+    UInt32* histogramKeys, UInt32* histogramCounts, UInt32& histogramSize)
+{
+    // the caller has already filtered forms by type code; stacks are few (one per distinct form in a container),
+    // so the histogram is a simple linear-probed list of distinct extraData values
+    memset(&totals,0,sizeof(totals));
+    histogramSize = 0;
+    for (UInt32 i = 0; i < count; i++)
+    {
+        MyForm* myform = (MyForm*)forms[i];
+        if (counts[i] <= 0) continue;
+        totals.stackCount++;
+        totals.itemCount += counts[i];
+        totals.totalWeight += (double)myform->weight * counts[i];
+        totals.totalValue += (double)myform->goldValue * counts[i];
+        UInt32 extraData = g_extraDataWrites.Read(myform);
+        UInt32 k = 0;
+        while (k < histogramSize && histogramKeys[k] != extraData) k++;
+        if (k == histogramSize) { histogramKeys[k] = extraData; histogramCounts[k] = 0; histogramSize++; }
+        histogramCounts[k] += counts[i];
+    }
+}
+SInt32 SubmoduleInterface::ReportMyFormConflicts()
+{
+    if (!g_myFormConflicts.enabled)
+    {
+        _WARNING("Conflict detection is disabled, see [Conflicts] in Settings.ini");
+        return -1;
+    }
+    return g_myFormConflicts.Report("Data\\obse\\plugins\\" SOLUTIONNAME "\\MyForm.Conflicts.txt");
+}
+bool SubmoduleInterface::DumpMyForms(bool json)
+{
+    return g_myFormDump.Start(json);
+}
+SInt32 SubmoduleInterface::MyFormDumpStatus()
+{
+    return g_myFormDump.GetStatus();
+}
+const SubmoduleCommandTable* SubmoduleInterface::CommandTable()
+{
+    // the form type is not known until MyForm is registered, so the table is filled in on first request
+    static SubmoduleCommandTable table = {0};
+    if (!table.version)
+    {
+        table.myFormType = MyForm::extendedForm.FormType();
+        table.GetMyFormExtraData = &Direct_GetMyFormExtraData;
+        table.SetMyFormExtraData = &Direct_SetMyFormExtraData;
+        table.version = SubmoduleCommandTable::kVersion;
+    }
+    return &table;
+}
 
@@ -6,6 +6,44 @@
 
 class   TESObjectREFR;      // COEF/API/TESForms/TESObjectREFR.h
 class   TESForm;            // COEF/API/TESForms/TESForm.h
+struct  MyFormBulkInterface;    // Submodule/BulkInterface.h
+
+// Compact table of handlers for frequently used script commands
+// The loader calls these directly, skipping the virtual SubmoduleInterface methods and any redundant
+// argument checking.  The handlers themselves do *no* type checking - the loader must compare the
+// form type of the argument to myFormType before dispatching.
+struct SubmoduleCommandTable
+{
+    enum { kVersion = 1 };
+
+    UInt32          version;        // kVersion
+    UInt8           myFormType;     // form type code assigned to MyForm
+    UInt8           pad05[3];
+    UInt32          (* GetMyFormExtraData)(TESForm* myForm);
+    void            (* SetMyFormExtraData)(TESForm* myForm, UInt32 extraData);
+};
+
+// Memory used by all MyForms, in bytes, as measured by SubmoduleInterface::GetMyFormMemoryUsage()
+// Heap block overhead is an estimate, since the actual allocator (game heap or CRT) is not inspected.
+struct MyFormMemoryUsage
+{
+    UInt32          formCount;      // number of MyForms
+    UInt32          objectBytes;    // fixed size of the form objects
+    UInt32          stringBytes;    // heap strings owned by the forms (name & icon path, editorID & description in CS)
+    UInt32          listNodeBytes;  // nodes of the extended form list
+    UInt32          indexBytes;     // formID & EditorID indexes, write buffer, snapshot buffers, and conflict tracking
+    UInt32          overheadBytes;  // estimated allocator overhead for heap blocks counted above
+    UInt32          totalBytes;     // sum of the above
+};
+
+// Totals over a set of MyForm stacks, as computed by SubmoduleInterface::AggregateMyForms()
+struct MyFormAggregate
+{
+    UInt32          stackCount;     // number of distinct MyForms
+    UInt32          itemCount;      // total number of items
+    double          totalWeight;    // sum of weight * count
+    double          totalValue;     // sum of gold value * count
+};
 
 class SubmoduleInterface
 {
@@ -13,7 +51,29 @@ public:
     // commands
     virtual /*00*/ void             ListMyForms();
     virtual /*04*/ void             SetMyFormExtraData(TESForm* myForm, UInt32 extraData);
-    virtual /*04*/ UInt32           GetMyFormExtraData(TESForm* form);
+    virtual /*08*/ UInt32           GetMyFormExtraData(TESForm* form);
     // internals
-    virtual /*04*/ const char*      Description();  // prints & returns a short description of this plugin
+    virtual /*0C*/ const char*      Description();  // prints & returns a short description of this plugin
+    virtual /*10*/ void             ListFormStatistics();   // dumps per-type statistics for all extended form classes
+    virtual /*14*/ const SubmoduleCommandTable* CommandTable();   // returns direct dispatch table for script commands
+    virtual /*18*/ UInt32           CommitMyFormWrites();   // applies all staged extraData writes, returns number applied
+    virtual /*1C*/ UInt32           GetMyFormsInRange(UInt32 firstFormID, UInt32 lastFormID, TESForm* const*& forms); // returns number of MyForms with formIDs
+                                                            // in [first, last] and a pointer to a contiguous array of them, sorted by formID
+    virtual /*20*/ void             GetMyFormMemoryUsage(MyFormMemoryUsage& usage); // measures memory used by all MyForms
+    virtual /*24*/ TESForm*         GetMyFormByEditorID(const char* editorID);  // returns the MyForm with the specified EditorID, or null
+    virtual /*28*/ bool             DumpMyForms(bool json); // starts writing all MyForms to a CSV or JSON file in the background, returns false if busy
+    virtual /*2C*/ SInt32           MyFormDumpStatus();     // returns 0 if no dump was started, 1 if running, 2 if done, -1 if failed
+    virtual /*30*/ UInt32           ApplyMyFormExtraData(const UInt32* formIDs, const UInt32* extraData, UInt32 count); // sets extraData of the MyForms with
+                                                            // the specified formIDs, which must be sorted, and returns the number of forms found
+    virtual /*34*/ void             AggregateMyForms(TESForm* const* forms, const SInt32* counts, UInt32 count, MyFormAggregate& totals,
+                                        UInt32* histogramKeys, UInt32* histogramCounts, UInt32& histogramSize); // totals over stacks of MyForms, and item
+                                                            // counts by extraData value; histogram arrays must hold 'count' entries
+    virtual /*38*/ SInt32           ReportMyFormConflicts();    // writes load order conflict report, returns number of forms with conflicts,
+                                                            // or -1 if conflict detection is disabled or the report could not be written
+    virtual /*3C*/ bool             ExportMyFormColumns(const char* path);  // writes all MyForms to a columnar binary file, see MyFormColumns.h
+    // other plugins
+    virtual /*40*/ const MyFormBulkInterface* BulkInterface();  // returns bulk data interface, dispatched to other plugins on request
+    // plugin files
+    virtual /*44*/ SInt32           CompressMyFormRecords(const char* path);    // compresses large MyForm records in a saved plugin file,
+                                                            // returns number of records compressed, or -1 if the file could not be rewritten
 };
@@ -0,0 +1,67 @@
+#include "Submodule/MenuRouter.h"
+#include "Components/EventManager.h"
+
+/*--------------------------------------------------------------------------------------------*/
+// routing table, indexed by (identifier - IdentifierBase())
+struct MenuRoute
+{
+    MenuRouter::Handler handler;
+    void*               param;
+};
+static MenuRoute    s_routes[MenuRouter::kIdentifierCount] = {0};
+static UInt32       s_routeCount = 0;   // identifiers are allocated sequentially
+static UInt32       s_identifierBase = 0;   // zero until the range is placed
+
+/*--------------------------------------------------------------------------------------------*/
+void MenuRouter::PlaceRange(UInt8 formType)
+{
+    if (s_identifierBase) return;   // already placed
+    s_identifierBase = kIdentifierRangeStart + (formType << 4);
+    _VMESSAGE("Menu identifiers reserved in [0x%04X, 0x%04X)",s_identifierBase,s_identifierBase + kIdentifierCount);
+}
+UInt32 MenuRouter::IdentifierBase()
+{
+    return s_identifierBase;
+}
+UInt32 MenuRouter::Allocate(Handler handler, void* param)
+{
+    if (!s_identifierBase) return 0; // range not placed
+    if (s_routeCount >= kIdentifierCount) return 0; // range exhausted
+    s_routes[s_routeCount].handler = handler;
+    s_routes[s_routeCount].param = param;
+    return s_identifierBase + s_routeCount++;
+}
+bool MenuRouter::Dispatch(UInt32 identifier)
+{
+    UInt32 index = identifier - s_identifierBase; // identifiers below the base wrap around to large values
+    if (index >= kIdentifierCount || !s_routes[index].handler) return false;
+    s_routes[index].handler(s_routes[index].param);
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+#ifndef OBLIVION
+LRESULT MenuRouter_CSMenuHook(WPARAM wparam, LPARAM lparam)
+{
+    /*
+        CSMainWindow_WMCommand event handler
+        Peeks at WM_COMMAND messages sent to the main CS window
+        Returns zero if message has been handled
+    */
+    return MenuRouter::Dispatch(LOWORD(wparam)) ? 0 : 1;
+}
+#endif
+void MenuRouter::Attach()
+{
+    #ifndef OBLIVION
+    static bool attached = false;
+    if (attached) return;
+
+    // register CSWindows::MainW_WMCommand event handler with the EventManager COEF component
+    // this event occurs when WM_COMMAND messages are sent to the main CS window
+    // This includes menu selections by the user, so this event handler will be able to
+    // determine when the user clicks on any of the newly added menu items.
+    EventManager::CSWindows::MainW_WMCommand.RegisterCallback(&MenuRouter_CSMenuHook);
+    attached = true;
+    #endif
+}
@@ -0,0 +1,32 @@
+/*
+    Menu command router
+
+    All CS menu items (and any other WM_COMMAND sources) added by this plugin take their identifiers from
+    a single reserved range, [IdentifierBase(), IdentifierBase() + kIdentifierCount).  The router maps each
+    identifier in the range directly to its handler with a table lookup, and registers a single callback
+    with the COEF EventManager for the main CS window, so the cost of a WM_COMMAND message that is not ours
+    is one range check, regardless of how many menu items this plugin adds.
+
+    The range is placed by the first form type the plugin registers: IdentifierBase() is
+    kIdentifierRangeStart + (formType << 4), giving each plugin kIdentifierCount (16) identifiers.  Form types
+    are unique across all plugins loaded, so plugins that use this scheme get disjoint ranges, all within
+    [0xCC00, 0xDC00).  A plugin that registers several form types still gets one range, from the first.
+*/
+#pragma once
+
+class MenuRouter
+{
+public:
+    typedef void (*Handler)(void* param);   // called when the command is received
+
+    // reserved identifier range
+    static const UInt32     kIdentifierRangeStart   = 0xCC00;   // range for form type zero
+    static const UInt32     kIdentifierCount        = 0x10;     // identifiers per plugin, the spacing of ranges by form type
+
+    // methods
+    static void             PlaceRange(UInt8 formType);     // places the range by form type; only the first call has any effect
+    static UInt32           IdentifierBase();   // first identifier in the range, zero if the range has not been placed
+    static UInt32           Allocate(Handler handler, void* param); // assigns the next free identifier to handler, returns zero if range is exhausted or not placed
+    static bool             Dispatch(UInt32 identifier);    // calls the handler for identifier, returns false if it is not routed here
+    static void             Attach();   // registers the router with the EventManager, once
+};
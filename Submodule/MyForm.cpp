@@ -1,11 +1,17 @@
 #include "Submodule/MyForm.h"
 #include "Submodule/Submodule.rc.h"
-#include "Components/EventManager.h"
+#include "Submodule/Timing.h"
+#include "Submodule/WriteBuffer.h"
+#include "Submodule/Trace.h"
+#include "Submodule/FormIndex.h"
+#include "Submodule/EditorIDIndex.h"
+#include "Submodule/ConflictTracker.h"
+#include "Submodule/Snapshot.h"
+#include "Submodule/Settings.h"
 
 #include "API/TES/TESDataHandler.h"
 #include "API/TESFiles/TESFile.h"
 #include "API/CSDialogs/TESDialog.h"
-#include "Utilities/Memaddr.h"
 
 // local declaration of module handle defined in submodule.cpp
 // this handle is needed to extract resources embedded in this module (e.g. dialog templates)
@@ -18,6 +24,21 @@ MyForm::~MyForm()
     /*
         Clean up any dynamically allocated members here.
     */
+    g_extraDataWrites.Discard(this); // drop any staged writes to this form
+    g_myFormIndex.Remove(this); // remove from formID index
+    g_myFormSnapshots.MarkChanged(); // next snapshot is published without this form
+    g_myFormEditorIDs.Remove(this); // remove from EditorID index
+    classInfo.OnDestruct(); // update instance statistics
+}
+// Returns true the first time an unexpected chunk type is seen, so each type is only warned about once
+// per session; records from a plugin with many unexpected chunks would otherwise flood the log.
+bool MyForm_FirstUnexpectedChunk(UInt32 chunktype)
+{
+    static UInt32 seenTypes[0x20];
+    static UInt32 seenCount = 0;
+    for (UInt32 i = 0; i < seenCount; i++) if (seenTypes[i] == chunktype) return false;
+    if (seenCount < sizeof(seenTypes)/sizeof(seenTypes[0])) seenTypes[seenCount++] = chunktype;
+    return true;
 }
 bool MyForm::LoadForm(TESFile& file)
 {
@@ -31,9 +52,19 @@ bool MyForm::LoadForm(TESFile& file)
         allow them to be loaded in a more flexible order - hence the loop and switch over chunk
         types.
 
+        Chunk lengths come from the file and should not be trusted: oversized EDID chunks are
+        truncated (with a warning), and DATA chunks of the wrong size are reported.  Problems are
+        counted in the per-type load statistics (see FormRegistry::ReportStatistics).
     */
 
+    UInt64 loadStart = PerfTicks(); // start timing for load statistics
+    TraceScope trace("LoadForm","MyForm");
+
     file.InitializeFormFromRecord(*this); // initialize formID, formFlags, etc. from record header
+    g_myFormIndex.Add(this); // formID may have changed, and the form is about to be listed
+    g_myFormSnapshots.MarkChanged(); // as may any other field
+    trace.SetArg(formID);
+    if (formFlags & kFormFlags_Compressed) _VMESSAGE("Record is compressed"); // chunks are decompressed transparently by TESFile
 
     char buffer[0x200];
     for(UInt32 chunktype = file.GetChunkType(); chunktype; chunktype = file.GetNextChunk() ? file.GetChunkType() : 0)
@@ -44,10 +75,17 @@ bool MyForm::LoadForm(TESFile& file)
 
         // editor id      
         case 'EDID':
-            memset(buffer,0,sizeof(buffer));    // initialize buffer to zero, good practice
+            if (file.currentChunk.chunkLength >= sizeof(buffer))
+            {
+                _WARNING("EDID chunk w/ size %08X truncated to %08X", file.currentChunk.chunkLength, sizeof(buffer)-1);
+                classInfo.OnLoadWarning();
+            }
             file.GetChunkData(buffer,sizeof(buffer)-1); // load chunk into buffer
+            // terminate string explicitly, rather than zeroing the entire buffer first
+            buffer[(file.currentChunk.chunkLength < sizeof(buffer)) ? file.currentChunk.chunkLength : sizeof(buffer)-1] = 0;
             _VMESSAGE("EDID chunk: '%s'",buffer);
             SetEditorID(buffer);
+            g_myFormEditorIDs.Add(this,buffer); // the game discards EditorIDs, so the index keeps its own copy
             break;   
 
         // name
@@ -72,20 +110,31 @@ bool MyForm::LoadForm(TESFile& file)
         case 'DATA':
             // load all simple BaseFormComponents using LoadGenericComponents()
             // the extraData value, specific to this form class, is stored at the end of the DATA chunk
+            if (file.currentChunk.chunkLength != sizeof(goldValue) + sizeof(weight) + sizeof(extraData))
+            {
+                _WARNING("DATA chunk has unexpected size %08X", file.currentChunk.chunkLength);
+                classInfo.OnLoadWarning();
+                extraData = 0; // in case the chunk is too short to contain it
+            }
             TESForm::LoadGenericComponents(file,&extraData,sizeof(extraData));
             _VMESSAGE("DATA chunk: value %i weight %f extraData %i",goldValue,weight,extraData);
             break;
 
         // unrecognized chunk type
         default:
+            classInfo.OnLoadWarning();
+            if (!MyForm_FirstUnexpectedChunk(chunktype)) break; // already reported
             gLog.PushStyle();
-            _WARNING("Unexpected chunk '%4.4s' {%08X} w/ size %08X", &chunktype, chunktype, file.currentChunk.chunkLength);
+            _WARNING("Unexpected chunk '%4.4s' {%08X} w/ size %08X (further chunks of this type will not be reported)", 
+                &chunktype, chunktype, file.currentChunk.chunkLength);
             gLog.PopStyle();
             break;
 
         }
         // continue to next chunk
     } 
+    g_myFormConflicts.Record(this,file); // record this version for conflict detection, if enabled
+    classInfo.OnLoad(PerfTicks() - loadStart); // update load statistics
     return true;
 }
 void MyForm::SaveFormChunks()
@@ -96,6 +145,7 @@ void MyForm::SaveFormChunks()
         This method must be overwritten (TESForm::SaveFormChunks does nothing), unless this
         form class derives from some child of TESForm that has already overwritten it.
     */
+    TraceScope trace("SaveFormChunks","MyForm",formID);
 
     // initialize the global Form Record memory buffer, to which chunks are written by all 'Save' methods
     // InitializeFormRecord() also automatically saves the EDID chunk
@@ -136,7 +186,13 @@ void MyForm::CopyFrom(TESForm& form)
     if (!source) return;    // source has wrong polymorphic type
 
     CopyAllComponentsFrom(form); // copy all BaseFormComponent properties
-    extraData = source->extraData; // copy extraData, which is specific this form class
+    extraData = g_extraDataWrites.Read(source); // copy extraData, which is specific this form class, including staged writes
+    g_myFormIndex.Add(this); // formID is copied if either form is temporary
+    // a CS dialog edits a temporary working copy, which is copied back onto the listed form when the edit is
+    // committed; only listed forms are indexed by EditorID, so the working copy never hides the real form
+    const char* editorID = source->GetEditorID();
+    if (editorID && *editorID && !g_myFormIndex.Contains(source) && g_myFormIndex.Contains(this)) g_myFormEditorIDs.Add(this,editorID);
+    g_myFormSnapshots.MarkChanged();
 
 }
 bool MyForm::CompareTo(TESForm& compareTo)
@@ -220,6 +276,7 @@ void MyForm::GetFromDialog(HWND dialog)
     // set the value of extraData from the current combo selection
     control = GetDlgItem(dialog,IDC_EXTRADATA);
     extraData = (UInt32)TESComboBox::GetCurSelData(control);
+    g_myFormSnapshots.MarkChanged();
 }
 void MyForm::CleanupDialog(HWND dialog)
 {
@@ -231,14 +288,6 @@ void MyForm::CleanupDialog(HWND dialog)
 }
 #endif
 
-// bitmask of virtual methods that need to be manually copied from vanilla vtbls (see notes in Constructor)
-#ifdef OBLIVION
-    const UInt32 TESForm_NoUseMethods[2] = { 0x86048400, 0x001E1FC7 };
-#else
-    const UInt32 TESForm_NoUseMethods[3] = { 0x090800D0, 0x0F783F8F, 0x00000105 };
-#endif
-memaddr TESForm_vtbl                (0x00A3BE3C,0x0093DA0C);
-
 // Constructor
 MyForm::MyForm()
 : TESFormIDListView(), TESFullName(), TESDescription(),TESIcon(),TESWeightForm(),TESValueForm(), extraData(0)
@@ -265,67 +314,41 @@ MyForm::MyForm()
         errors.
             To address this, the COEF vtbl must be patched at run time by copying the addresses of
         the NOUSE_ methods from the vanilla vtbl to fill in the blanks.  It needs to be done only
-        once per new form class, the first time that class' constructor is called.
+        once per new form class, so it is performed by FormRegistry::RegisterAll() when the class is
+        registered, and not here.  Keep this constructor free of one-time checks - it is called for 
+        every form loaded or cloned.
     */
-    static bool runonce = true;
-    if (runonce)
-    {
-        // patch up TESForm vtbl    
-        memaddr thisvtbl = (UInt32)memaddr::GetObjectVtbl(this);
-        _MESSAGE("Patching MyForm TESForm vtbl @ <%p>",thisvtbl);
-        gLog.Indent();
-        for (int i = 0; i < sizeof(TESForm_NoUseMethods)*0x8; i++)
-        {
-            if ((TESForm_NoUseMethods[i/0x20] >> (i%0x20)) & 1)
-            {
-                thisvtbl.SetVtblEntry(i*4,TESForm_vtbl.GetVtblEntry(i*4));
-                _VMESSAGE("Patched Offset 0x%04X",i*4);
-            }
-        }
-        gLog.Outdent();
 
-        runonce  =  false;
-    }
+    classInfo.OnConstruct(); // update instance statistics
+    g_myFormIndex.Add(this); // indexed on the next query, once this form has been added to the FormList
+    g_myFormSnapshots.MarkChanged();
 }
 // COEF ExtendedForm component
 // This global object is used to register the form class with the ExtendedForm COEF component
 ExtendedForm MyForm::extendedForm(SOLUTIONNAME,MYFORM_CLASSNAME,MYFORM_CLASSNAME,MyForm::CreateMyForm);  
 TESForm* MyForm::CreateMyForm() { return new MyForm; } // method used by ExtendedForm to create new instances of this class
 
+// Record compression
+// record bodies at or above this size are compressed by the CompressMyForms pass
+UInt32 MyForm::compressionThreshold = 0x400;
+
+// Compiler-generated vtbl
+// C++ offers no way to name a class' vtbl, so the decorated name of the primary (TESFormIDListView) vtbl
+// of MyForm is aliased to a plain symbol at link time.  The vtbl is patched by the FormRegistry.
+extern "C" const UInt32 MyForm_vtbl[];
+#pragma comment(linker, "/alternatename:_MyForm_vtbl=??_7MyForm@@6BTESFormIDListView@@@")
+
+// FormRegistry class descriptor
+// This global object describes the form class to the FormRegistry, and collects per-type statistics
+#ifdef OBLIVION
+FormClassInfo MyForm::classInfo(MyForm::extendedForm,MYFORM_SHORTNAME,MYFORM_CLASSNAME,sizeof(MyForm),MyForm_vtbl,MyForm::CreateMyForm,MyForm::InitializeMyForm,0);
+#else
+FormClassInfo MyForm::classInfo(MyForm::extendedForm,MYFORM_SHORTNAME,MYFORM_CLASSNAME,sizeof(MyForm),MyForm_vtbl,MyForm::CreateMyForm,MyForm::InitializeMyForm,MyForm::OpenDialog);
+#endif
+
 // CS dialog management 
 #ifndef OBLIVION
-UInt32 MyForm::kMenuIdentifier = 0xCC00;    // unique identifier for new menu item (see InitializeMyForm())
 HWND  MyForm::dialogHandle = 0; // handle of open dialog window, if any
-void MyForm_AddMenuItem()
-{
-    // insert new item into CS main menu
-    HMENU menu = GetMenu(TESDialog::csHandle); // get main CS menu handle
-    menu = GetSubMenu(menu,3);              // get 'World' submenu handle
-    MENUITEMINFO iteminfo;      
-    iteminfo.cbSize = sizeof(iteminfo);        
-    iteminfo.fMask = MIIM_ID | MIIM_FTYPE | MIIM_STRING;
-    iteminfo.fType = MFT_STRING;
-    char menulabel[] = SOLUTIONNAME " " MYFORM_CLASSNAME " ...";
-    iteminfo.dwTypeData = menulabel;
-    iteminfo.cch = sizeof(menulabel);
-    iteminfo.wID = MyForm::kMenuIdentifier;
-    InsertMenuItem(menu,0,true,&iteminfo); // Insert new entry at top of submenu
-}
-LRESULT MyForm_CSMenuHook(WPARAM wparam, LPARAM lparam)
-{
-    /*
-        CSMainWindow_WMCommand event handler
-        Peeks at WM_COMMAND messages sent to the main CS window
-        Returns zero if message has been handled
-    */
-    if (LOWORD(wparam) == MyForm::kMenuIdentifier)
-    {
-        // WM_COMMAND messagesent by new menu item
-        MyForm::OpenDialog();
-        return 0;
-    }
-    return 1;
-}
 void MyForm::OpenDialog()
 {
     /*
@@ -349,38 +372,18 @@ void MyForm::OpenDialog()
 }
 #endif
 
-// global initialization function
+// class initialization function
 void MyForm::InitializeMyForm()
 {
     /*
         Perform one-time initialization required for this form class
+        This is called by FormRegistry::RegisterAll() after the class has been registered with the
+        ExtendedForm COEF component and assigned a menu identifier.  Registration, CS menu items, and
+        the main CS window hook are handled by the FormRegistry for all classes.
     */
     _MESSAGE("Initializing " MYFORM_CLASSNAME " ...");
 
-    // register form type with the ExtendedForm COEF component
-    extendedForm.Register(MYFORM_SHORTNAME);
-    
-    #ifndef OBLIVION
-
-    // generate a (hopefully) unqiue menu identifier from form type
-    kMenuIdentifier += extendedForm.FormType();
-
-    // attempt to add new menu item to the CS
-    // this may fail for newer (v21+) versions of OBSE that load plugins before 
-    // the CS main window has been initialized.
-    MyForm_AddMenuItem();
-
-    // register CSWindows::InitializeWindows event handler with the EventManager COEF component
-    // this event occurs during startup, after the CS has initialized the main MDI window and menu
-    // items cannot be added to the main CS menu until this event has occurred
-    // older versions of OBSE (<= v20) load plugins *after* this event, meaning it will never be trapped
-    EventManager::CSWindows::InitializeWindows.RegisterCallback(&MyForm_AddMenuItem);
-
-    // register CSWindows::MainW_WMCommand event handler with the EventManager COEF component
-    // this event occurs when WM_COMMAND messages are sent to the main CS window
-    // This includes menu selections by the user, so this event handler will be able to
-    // determine when the user clicks on the newly added menu item.
-    EventManager::CSWindows::MainW_WMCommand.RegisterCallback(&MyForm_CSMenuHook);
-
-    #endif
+    // load record compression settings
+    compressionThreshold = GetSettingInt("Compression","Threshold",0x400);
+    _VMESSAGE("Record compression threshold: %i bytes",compressionThreshold);
 }
\ No newline at end of file
@@ -29,8 +29,9 @@
         Each item in a menu must have a unique identifier, used to identify it when it is selected 
         by the user.  There are quite a few possible identifiers (any 16 bit number > ~0x4000 works),
         but the possibility for conflict with other plugins that insert menu or toolbar items remains.
-        The identifier for the new menu item introduced to open the MyForms dialog is determined by 
-        adding the assigned form type to a base value 0xCC00.
+        The identifier for the new menu item introduced to open the MyForms dialog is assigned by
+        the FormRegistry from a managed range at 0xCC00 + (form type << 4), derived from the first
+        form type this plugin registers (see MenuRouter.h).
 */
 #pragma once
 
@@ -38,6 +39,7 @@
 #include "API/TESForms/TESForm.h" // TESFormIDListView
 #include "API/TESForms/BaseFormComponent.h" // additonal form components
 #include "Components/ExtendedForm.h"
+#include "Submodule/FormRegistry.h"
 
 // Macros for short name and class name, which must be unique among all plugins, and just this plugin, respectively
 #define MYFORM_SHORTNAME "MYFM"
@@ -61,6 +63,7 @@ public:
     //     /*38/58*/ TESValueForm   08/08
     //     /*40/60*/ TESWeightForm  08/08
     MEMBER /*48/68*/ UInt32         extraData;  // one new member, in addition to the base clases
+                                                // written atomically, see Snapshot.h for access from other threads
     //       4C/6C <-- total object size
 
     // TESFormIDListView virtual method overrides
@@ -85,14 +88,22 @@ public:
     static ExtendedForm         extendedForm; 
     _LOCAL static TESForm*      CreateMyForm(); // creates a blank MyForm
 
+    // FormRegistry class descriptor & statistics
+    static FormClassInfo        classInfo;
+
+    // record compression
+    // Records flagged as compressed are stored zlib-compressed in the plugin file; TESFile inflates them
+    // transparently on load.  The CS saves all records raw; see RecordCompression.h for the compression pass.
+    static const UInt32         kFormFlags_Compressed = 0x00040000; // record header flag, never set on forms in memory
+    static UInt32               compressionThreshold; // minimum record body size to compress, in bytes
+
     // CS dialog management
     #ifndef OBLIVION
-    static UInt32               kMenuIdentifier;   // identifier for new menu item
-    static HWND                 dialogHandle; // handle of dialog if currently open
+    static HWND                 dialogHandle; // handle of dialog if currently open, CS UI thread only
     _LOCAL static void          OpenDialog(); // opens dialog if it is not currently open
     #endif
 
-    // global initialization function, called once when submodule is first loaded
+    // class initialization function, called once by the FormRegistry after registration
     _LOCAL static void          InitializeMyForm();
 
 private:
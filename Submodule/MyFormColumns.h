@@ -0,0 +1,119 @@
+#pragma once
+
+/*** MyForm Columnar Export Format ***********
+*   Layout of the binary file written by the ExportMyFormColumns command, and a small reader for it.
+*   The file is designed to be memory mapped and scanned in place by external tools:
+*   -   a fixed header, followed by a table of column descriptors
+*   -   one contiguous array per field, each 8-byte aligned, with one element per form
+*   -   string fields are stored as arrays of byte offsets into a shared pool of null-terminated
+*       strings (UTF-8 is not guaranteed; strings are stored as the game/CS holds them)
+*   All values are little-endian, and element types have fixed widths.  Rows are sorted by formID.
+*
+*   This header is self-contained (it depends on nothing but the C++ language), and may be copied
+*   into other projects.  MyFormColumnsReader does no I/O - map or read the file yourself, and pass
+*   it the whole file.
+********************************************/
+
+struct MyFormColumnsHeader
+{
+   enum { kMagic = 0x4346594D, kVersion = 1 };   // "MYFC" as little-endian bytes
+
+   unsigned int   magic;         // kMagic
+   unsigned int   version;       // kVersion
+   unsigned int   rowCount;      // number of forms
+   unsigned int   columnCount;   // number of column descriptors following the header
+};
+
+struct MyFormColumnDesc
+{
+   enum Columns
+   {
+      kColumn_FormID       = 0,  // unsigned int
+      kColumn_FormType,          // unsigned char
+      kColumn_Value,             // int
+      kColumn_Weight,            // float
+      kColumn_ExtraData,         // unsigned int
+      kColumn_EditorID,          // unsigned int, offsets into kColumn_Strings
+      kColumn_Name,              // unsigned int, offsets into kColumn_Strings
+      kColumn_Icon,              // unsigned int, offsets into kColumn_Strings
+      kColumn_Description,       // unsigned int, offsets into kColumn_Strings
+      kColumn_Strings,           // char, string pool
+      kColumn__MAX
+   };
+
+   unsigned int   column;        // column id, from Columns
+   unsigned int   elementSize;   // size of each element in bytes (1 for the string pool)
+   unsigned int   offset;        // offset of column data from start of file
+   unsigned int   size;          // size of column data in bytes
+};
+
+class MyFormColumnsReader
+{
+public:
+   // validates file & locates columns, returns false if the file is malformed or of another version
+   bool Open(const void* file, unsigned int fileSize)
+   {
+      base = (const char*)file;
+      rows = 0;
+      for (unsigned int c = 0; c < MyFormColumnDesc::kColumn__MAX; c++) columns[c] = 0;
+      const MyFormColumnsHeader* header = (const MyFormColumnsHeader*)base;
+      if (!base || fileSize < sizeof(MyFormColumnsHeader)) return false;
+      if (header->magic != MyFormColumnsHeader::kMagic || header->version != MyFormColumnsHeader::kVersion) return false;
+      if (header->columnCount > (fileSize - sizeof(MyFormColumnsHeader)) / sizeof(MyFormColumnDesc)) return false;
+      const MyFormColumnDesc* descs = (const MyFormColumnDesc*)(header + 1);
+      for (unsigned int i = 0; i < header->columnCount; i++)
+      {
+         const MyFormColumnDesc& desc = descs[i];
+         if (desc.offset > fileSize || desc.size > fileSize - desc.offset) return false;
+         if (desc.column >= MyFormColumnDesc::kColumn__MAX) continue;  // unknown column, from a later minor revision
+         if (columns[desc.column]) return false;   // duplicate column
+         // element width must match the column's type, and the array must hold exactly one element per row
+         // (compared by division, as rowCount * elementSize can overflow)
+         if (desc.elementSize != ElementSize(desc.column)) return false;
+         if (desc.column != MyFormColumnDesc::kColumn_Strings &&
+            (desc.size % desc.elementSize != 0 || desc.size / desc.elementSize != header->rowCount)) return false;
+         columns[desc.column] = &desc;
+      }
+      for (unsigned int c = 0; c < MyFormColumnDesc::kColumn__MAX; c++) if (!columns[c]) return false;
+      stringPoolSize = columns[MyFormColumnDesc::kColumn_Strings]->size;
+      if (!stringPoolSize || base[columns[MyFormColumnDesc::kColumn_Strings]->offset + stringPoolSize - 1] != 0) return false;
+      rows = header->rowCount;
+      return true;
+   }
+
+   // width of a column's elements, in bytes
+   static unsigned int ElementSize(unsigned int column)
+   {
+      switch (column)
+      {
+      case MyFormColumnDesc::kColumn_FormType:
+      case MyFormColumnDesc::kColumn_Strings:   return 1;
+      default:                                  return 4;
+      }
+   }
+
+   // columns, indexed in parallel
+   unsigned int            RowCount() const { return rows; }
+   const unsigned int*     FormIDs() const { return (const unsigned int*)Column(MyFormColumnDesc::kColumn_FormID); }
+   const unsigned char*    FormTypes() const { return (const unsigned char*)Column(MyFormColumnDesc::kColumn_FormType); }
+   const int*              Values() const { return (const int*)Column(MyFormColumnDesc::kColumn_Value); }
+   const float*            Weights() const { return (const float*)Column(MyFormColumnDesc::kColumn_Weight); }
+   const unsigned int*     ExtraData() const { return (const unsigned int*)Column(MyFormColumnDesc::kColumn_ExtraData); }
+
+   // string fields of a row, never null; column is one of kColumn_EditorID, _Name, _Icon, _Description
+   const char* String(unsigned int column, unsigned int row) const
+   {
+      unsigned int offset = ((const unsigned int*)Column(column))[row];
+      return (offset < stringPoolSize) ? Column(MyFormColumnDesc::kColumn_Strings) + offset : "";
+   }
+
+   MyFormColumnsReader() : base(0), rows(0), stringPoolSize(0) {}
+
+private:
+   const char* Column(unsigned int column) const { return base + columns[column]->offset; }
+
+   const char*             base;
+   unsigned int            rows;
+   unsigned int            stringPoolSize;
+   const MyFormColumnDesc* columns[MyFormColumnDesc::kColumn__MAX];
+};
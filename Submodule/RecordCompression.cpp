@@ -0,0 +1,156 @@
+#include "Submodule/RecordCompression.h"
+#include "Submodule/Interface.h"
+#include "Submodule/MyForm.h"
+#include "Submodule/Timing.h"
+#include "Submodule/Trace.h"
+
+#include <zlib.h>
+
+/*--------------------------------------------------------------------------------------------*/
+// record bodies
+bool RecordCompression::Deflate(const UInt8* body, UInt32 size, std::vector<UInt8>& packed)
+{
+    uLongf packedSize = compressBound(size);
+    UInt32 start = packed.size();
+    packed.resize(start + sizeof(UInt32) + packedSize);
+    memcpy(&packed[start],&size,sizeof(UInt32));
+    if (compress2(&packed[start + sizeof(UInt32)],&packedSize,body,size,Z_DEFAULT_COMPRESSION) != Z_OK)
+    {
+        packed.resize(start);
+        return false;
+    }
+    packed.resize(start + sizeof(UInt32) + packedSize);
+    return true;
+}
+bool RecordCompression::Inflate(const UInt8* packed, UInt32 size, std::vector<UInt8>& body)
+{
+    UInt32 rawSize = 0;
+    if (size < sizeof(UInt32)) return false;
+    memcpy(&rawSize,packed,sizeof(UInt32));
+    body.resize(rawSize);
+    uLongf bodySize = rawSize;
+    if (uncompress(rawSize ? &body[0] : 0,&bodySize,packed + sizeof(UInt32),size - sizeof(UInt32)) != Z_OK || bodySize != rawSize)
+    {
+        body.clear();
+        return false;
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// plugin files
+bool RecordCompression::CompressRange(const UInt8* data, UInt32 size, std::vector<UInt8>& result, UInt32 recordType,
+    UInt32 threshold, RecordCompressionStats& stats)
+{
+    // a sequence of records & groups; groups have the same size header as records, but their size includes the header
+    for (UInt32 offset = 0; offset < size;)
+    {
+        if (size - offset < kRecordHeaderSize) return false;
+        const UInt8* header = data + offset;
+        UInt32 dataSize, flags;
+        memcpy(&dataSize,header + 4,4);
+        memcpy(&flags,header + 8,4);
+        if (!memcmp(header,"GRUP",4))
+        {
+            if (dataSize < kRecordHeaderSize || dataSize > size - offset) return false;
+            UInt32 start = result.size();
+            result.insert(result.end(),header,header + kRecordHeaderSize);
+            if (!CompressRange(header + kRecordHeaderSize,dataSize - kRecordHeaderSize,result,recordType,threshold,stats)) return false;
+            UInt32 groupSize = result.size() - start;
+            memcpy(&result[start + 4],&groupSize,4);
+            offset += dataSize;
+            continue;
+        }
+        if (dataSize > size - offset - kRecordHeaderSize) return false;
+        const UInt8* body = header + kRecordHeaderSize;
+        UInt32 start = result.size();
+        bool packed = false;
+        if (!memcmp(header,&recordType,4))
+        {
+            stats.records++;
+            if (!(flags & kFormFlags_Compressed) && dataSize >= threshold)
+            {
+                result.insert(result.end(),header,header + kRecordHeaderSize);
+                packed = Deflate(body,dataSize,result) && result.size() - start - kRecordHeaderSize < dataSize;
+                if (packed)
+                {
+                    UInt32 packedSize = result.size() - start - kRecordHeaderSize;
+                    flags |= kFormFlags_Compressed;
+                    memcpy(&result[start + 4],&packedSize,4);
+                    memcpy(&result[start + 8],&flags,4);
+                    stats.compressed++;
+                    stats.rawBytes += dataSize;
+                    stats.packedBytes += packedSize;
+                }
+                else result.resize(start);  // would not shrink
+            }
+        }
+        if (!packed) result.insert(result.end(),header,body + dataSize);
+        offset += kRecordHeaderSize + dataSize;
+    }
+    return true;
+}
+bool RecordCompression::CompressPlugin(const std::vector<UInt8>& plugin, std::vector<UInt8>& result, UInt32 recordType,
+    UInt32 threshold, RecordCompressionStats& stats)
+{
+    memset(&stats,0,sizeof(stats));
+    result.clear();
+    result.reserve(plugin.size());
+    if (plugin.size() < kRecordHeaderSize || memcmp(&plugin[0],"TES4",4)) return false;
+    return CompressRange(&plugin[0],plugin.size(),result,recordType,threshold,stats);
+}
+bool RecordCompression::CompressPluginFile(const char* path, UInt32 recordType, UInt32 threshold, RecordCompressionStats& stats)
+{
+    memset(&stats,0,sizeof(stats));
+    FILE* file = 0;
+    if (fopen_s(&file,path,"rb") != 0 || !file)
+    {
+        _ERROR("Could not open plugin file '%s'",path);
+        return false;
+    }
+    std::vector<UInt8> plugin;
+    UInt8 buffer[0x10000];
+    for (size_t read; (read = fread(buffer,1,sizeof(buffer),file)) > 0;) plugin.insert(plugin.end(),buffer,buffer + read);
+    fclose(file);
+
+    std::vector<UInt8> result;
+    if (!CompressPlugin(plugin,result,recordType,threshold,stats))
+    {
+        _ERROR("Plugin file '%s' is malformed, and was not modified",path);
+        return false;
+    }
+    if (!stats.compressed) return true;  // nothing to rewrite
+
+    // write to a temporary file, then replace the original, so a failed write never leaves a truncated plugin
+    char tempPath[MAX_PATH];
+    sprintf_s(tempPath,sizeof(tempPath),"%s.tmp",path);
+    if (fopen_s(&file,tempPath,"wb") != 0 || !file)
+    {
+        _ERROR("Could not open temporary file '%s'",tempPath);
+        return false;
+    }
+    bool written = fwrite(&result[0],1,result.size(),file) == result.size();
+    written = (fclose(file) == 0) && written;
+    if (!written || !MoveFileEx(tempPath,path,MOVEFILE_REPLACE_EXISTING))
+    {
+        _ERROR("Could not replace plugin file '%s'",path);
+        remove(tempPath);
+        return false;
+    }
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// submodule interface
+SInt32 SubmoduleInterface::CompressMyFormRecords(const char* path)
+{
+    TraceScope trace("CompressMyFormRecords","MyForm");
+    UInt64 start = PerfTicks();
+    UInt32 recordType;
+    memcpy(&recordType,MYFORM_SHORTNAME,4); // in file byte order
+    RecordCompressionStats stats;
+    if (!RecordCompression::CompressPluginFile(path,recordType,MyForm::compressionThreshold,stats)) return -1;
+    _MESSAGE("Compressed %i of %i MyForm records in '%s' from %i to %i bytes in %.3f ms",
+        stats.compressed,stats.records,path,stats.rawBytes,stats.packedBytes,PerfTicksToMS(PerfTicks() - start));
+    return stats.compressed;
+}
@@ -0,0 +1,46 @@
+/*
+    Compression of MyForm records in saved plugin files
+
+    The engine reads compressed records transparently: when the compressed flag is set in a record header,
+    TESFile inflates the record body before the first chunk is read, so LoadForm sees the same chunks
+    either way.  The CS never writes compressed records, however, and the flag must not be set on a form
+    in memory (the record writer would save a raw body under a compressed header).  Compression is
+    therefore applied to a plugin file after it has been saved: CompressPluginFile() rewrites the file,
+    deflating the body of every record of the specified type at or above a size threshold with zlib.
+
+    As in the master files, a compressed body is the 32-bit size of the raw body, followed by the zlib
+    stream.  Records that would not shrink, and records that are already compressed, are left as they are.
+    Group sizes are updated to match; all other records & groups are copied unchanged.
+*/
+#pragma once
+
+#include <vector>
+
+// Totals for one compression pass
+struct RecordCompressionStats
+{
+    UInt32          records;        // records of the specified type
+    UInt32          compressed;     // records compressed by this pass
+    UInt32          rawBytes;       // body size of the compressed records, before compression
+    UInt32          packedBytes;    // body size of the compressed records, after compression
+};
+
+class RecordCompression
+{
+public:
+    static const UInt32 kFormFlags_Compressed   = 0x00040000;   // record header flag
+    static const UInt32 kRecordHeaderSize       = 20;           // type, data size, flags, formID, version control info
+
+    // record bodies
+    static bool     Deflate(const UInt8* body, UInt32 size, std::vector<UInt8>& packed);   // appends size & zlib stream
+    static bool     Inflate(const UInt8* packed, UInt32 size, std::vector<UInt8>& body);   // returns false if malformed
+
+    // plugin files, returns false if the file is malformed (in which case it is not modified)
+    static bool     CompressPlugin(const std::vector<UInt8>& plugin, std::vector<UInt8>& result, UInt32 recordType,
+                        UInt32 threshold, RecordCompressionStats& stats);
+    static bool     CompressPluginFile(const char* path, UInt32 recordType, UInt32 threshold, RecordCompressionStats& stats);
+
+private:
+    static bool     CompressRange(const UInt8* data, UInt32 size, std::vector<UInt8>& result, UInt32 recordType,
+                        UInt32 threshold, RecordCompressionStats& stats);
+};
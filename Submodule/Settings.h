@@ -0,0 +1,17 @@
+/*
+    Settings for this plugin
+    Shared by the loader and the submodule.  All settings are read from Settings.ini, in the
+    plugin folder, which also contains the log filter rules for the various output targets.
+*/
+#pragma once
+
+// path to settings file, relative to the Oblivion directory
+#define SETTINGS_INI    "Data\\obse\\Plugins\\" SOLUTIONNAME "\\Settings.ini"
+
+// reads an integer setting, returning defaultValue if the setting is not present
+// the windows profile API treats paths without a leading directory as relative to the windows folder,
+// so the path is explicitly made relative to the working (Oblivion) directory
+inline int GetSettingInt(const char* section, const char* key, int defaultValue)
+{
+    return GetPrivateProfileInt(section,key,defaultValue,".\\" SETTINGS_INI);
+}
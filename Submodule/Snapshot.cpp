@@ -0,0 +1,115 @@
+#include "Submodule/Snapshot.h"
+#include "Submodule/MyForm.h"
+
+/*--------------------------------------------------------------------------------------------*/
+// MyFormSnapshot
+MyFormSnapshot::MyFormSnapshot()
+: generation(0), count(0), formIDs(0), extraData(0), goldValues(0), weights(0),
+  capacity(0), readers(0), nextInPool(0)
+{
+}
+MyFormSnapshot::~MyFormSnapshot()
+{
+    delete [] formIDs;
+    delete [] extraData;
+    delete [] goldValues;
+    delete [] weights;
+}
+void MyFormSnapshot::Reserve(UInt32 newCount)
+{
+    // only called on buffers that are not active and not pinned by any reader
+    if (newCount <= capacity) return;
+    UInt32 newCapacity = capacity ? capacity : 0x100;
+    while (newCapacity < newCount) newCapacity *= 2;
+    delete [] formIDs;      formIDs = new UInt32[newCapacity];
+    delete [] extraData;    extraData = new UInt32[newCapacity];
+    delete [] goldValues;   goldValues = new SInt32[newCapacity];
+    delete [] weights;      weights = new float[newCapacity];
+    capacity = newCapacity;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// MyFormSnapshots
+MyFormSnapshots g_myFormSnapshots;
+
+MyFormSnapshots::MyFormSnapshots()
+: active(0), pool(0), generation(0), changed(true)
+{
+}
+MyFormSnapshots::~MyFormSnapshots()
+{
+    while (pool)
+    {
+        MyFormSnapshot* next = pool->nextInPool;
+        delete pool;
+        pool = next;
+    }
+}
+bool MyFormSnapshots::Publish()
+{
+    if (!changed) return false; // the active snapshot is still current
+    changed = false;
+
+    // find a buffer that is neither active nor pinned, or add a new one to the pool
+    MyFormSnapshot* snapshot = pool;
+    for (; snapshot; snapshot = snapshot->nextInPool)
+    {
+        if (snapshot != active && snapshot->readers == 0) break;
+    }
+    if (!snapshot)
+    {
+        snapshot = new MyFormSnapshot;
+        snapshot->nextInPool = pool;
+        pool = snapshot;
+    }
+
+    // count forms & size columns
+    BSSimpleList<TESForm*>& formList = MyForm::extendedForm.FormList();
+    UInt32 count = 0;
+    for (BSSimpleList<TESForm*>::Node* node = &formList.firstNode; node && node->data; node = node->next) count++;
+    snapshot->Reserve(count);
+
+    // fill columns
+    UInt32 i = 0;
+    for (BSSimpleList<TESForm*>::Node* node = &formList.firstNode; node && node->data; node = node->next, i++)
+    {
+        MyForm* myform = (MyForm*)node->data;
+        snapshot->formIDs[i] = myform->formID;
+        snapshot->extraData[i] = myform->extraData;
+        snapshot->goldValues[i] = myform->goldValue;
+        snapshot->weights[i] = myform->weight;
+    }
+    snapshot->count = count;
+    snapshot->generation = generation + 1;
+
+    // publish - the interlocked exchange is a full barrier, so the columns are visible before the pointer
+    InterlockedExchangePointer((PVOID volatile*)&active, snapshot);
+    InterlockedIncrement((volatile LONG*)&generation);
+    _VMESSAGE("Published MyForm snapshot generation %i with %i forms",snapshot->generation,count);
+    return true;
+}
+UInt32 MyFormSnapshots::MemoryUsage()
+{
+    // the pool is only modified by Publish(), so it can be walked safely from the main thread
+    UInt32 bytes = 0;
+    for (MyFormSnapshot* snapshot = pool; snapshot; snapshot = snapshot->nextInPool)
+    {
+        bytes += sizeof(MyFormSnapshot) + snapshot->capacity * (sizeof(UInt32) + sizeof(UInt32) + sizeof(SInt32) + sizeof(float));
+    }
+    return bytes;
+}
+const MyFormSnapshot* MyFormSnapshots::Acquire()
+{
+    for (;;)
+    {
+        MyFormSnapshot* snapshot = active;
+        if (!snapshot) return 0;
+        InterlockedIncrement(&snapshot->readers);   // pin
+        if (snapshot == active) return snapshot;    // still active, so it cannot be recycled while pinned
+        InterlockedDecrement(&snapshot->readers);   // a publish happened in between, try again
+    }
+}
+void MyFormSnapshots::Release(const MyFormSnapshot* snapshot)
+{
+    InterlockedDecrement(&const_cast<MyFormSnapshot*>(snapshot)->readers);
+}
@@ -0,0 +1,99 @@
+/*
+    Concurrent read access to MyForm data
+
+    The game and CS are single threaded as far as forms are concerned: forms are created, loaded,
+    modified and destroyed on the main thread, and nothing in the engine synchronizes access to them.
+    Worker threads must therefore never dereference a MyForm directly.  Instead, the main thread
+    periodically publishes a snapshot of the scalar MyForm fields, and workers read from that.
+
+    Concurrency model:
+    -   Snapshots are immutable once published, and stored as columns (one contiguous array per field).
+    -   Publish() is called only from the main thread.  It fills a free snapshot buffer and makes it
+        the active snapshot with a single atomic pointer exchange, so it never waits for readers.
+    -   Readers on any thread Acquire() the active snapshot, which pins it with a reader count, and
+        Release() it when done.  Acquire() never blocks; it only retries if a publish happens between
+        reading the active pointer and pinning it.
+    -   Snapshots are only as current as the last publish.  The loader publishes before saving, after
+        loading a game, when staged writes are committed, and on request through the bulk interface.
+        Writes applied immediately (with the write buffer disabled) are not published one by one, since
+        a publish walks every form; they appear in the next snapshot.
+    -   A publish is skipped, keeping the same snapshot & generation, unless MarkChanged() was called
+        since the last one.  The submodule marks every change it makes or sees: forms constructed, loaded,
+        copied, edited or destroyed, and extraData written, committed or applied.  Changes made to base
+        form fields by the engine or other plugins (e.g. a script setting the gold value) are not seen,
+        and appear with the next marked change.
+    -   Snapshot buffers are recycled, never freed, while the plugin is loaded.  A buffer is reused
+        only when it is not active and has no readers; a reader that pins a buffer that is being
+        recycled sees that it is no longer active and retries.
+    -   Individual scalar fields (e.g. MyForm::extraData) are written with interlocked operations,
+        so a 32-bit read from another thread never sees a torn value.  Other form members (strings,
+        lists) remain main-thread only.
+    -   MyForm::dialogHandle is CS-only and is only touched by the CS UI thread.
+*/
+#pragma once
+
+// atomic access to aligned 32-bit fields
+inline UInt32 AtomicLoad(const volatile UInt32& field) { UInt32 value = field; _ReadWriteBarrier(); return value; }
+inline void   AtomicStore(volatile UInt32& field, UInt32 value) { InterlockedExchange((volatile LONG*)&field, (LONG)value); }
+
+// An immutable, columnar snapshot of the scalar fields of all MyForms
+class MyFormSnapshot
+{
+public:
+    // members
+    UInt32          generation;     // incremented on every publish
+    UInt32          count;          // number of forms in snapshot
+    UInt32*         formIDs;        // column of formIDs, in FormList order
+    UInt32*         extraData;      // column of extraData values
+    SInt32*         goldValues;     // column of gold values
+    float*          weights;        // column of weights
+
+private:
+    friend class MyFormSnapshots;
+
+    UInt32          capacity;       // allocated size of each column
+    volatile LONG   readers;        // number of readers currently pinning this snapshot
+    MyFormSnapshot* nextInPool;     // next buffer in pool
+
+    MyFormSnapshot();
+    ~MyFormSnapshot();
+    void            Reserve(UInt32 count);
+};
+
+// Publisher & pool of MyFormSnapshot buffers
+class MyFormSnapshots
+{
+public:
+    // main thread only
+    bool                    Publish();  // captures the current state of all MyForms as the new active snapshot, if
+                                        // anything changed since the last publish; returns true if a snapshot was published
+    inline void             MarkChanged() { changed = true; }   // MyForm data has changed since the last publish
+
+    // any thread
+    const MyFormSnapshot*   Acquire();  // pins & returns the active snapshot, or null if nothing has been published
+    void                    Release(const MyFormSnapshot* snapshot); // unpins a snapshot returned by Acquire()
+    inline UInt32           Generation() { return generation; }    // generation of the active snapshot
+    UInt32                  MemoryUsage();  // bytes used by all pooled snapshot buffers, main thread only
+
+    // constructor, destructor
+    MyFormSnapshots();
+    ~MyFormSnapshots();
+
+private:
+    MyFormSnapshot* volatile    active;     // current snapshot
+    MyFormSnapshot*             pool;       // all snapshot buffers, active or not
+    volatile UInt32             generation;
+    bool                        changed;    // main thread only
+};
+
+// global snapshot publisher
+extern MyFormSnapshots g_myFormSnapshots;
+
+// Pins the active snapshot for the lifetime of this object
+class MyFormSnapshotLock
+{
+public:
+    const MyFormSnapshot*   snapshot;   // may be null if nothing has been published
+    MyFormSnapshotLock() : snapshot(g_myFormSnapshots.Acquire()) {}
+    ~MyFormSnapshotLock() { if (snapshot) g_myFormSnapshots.Release(snapshot); }
+};
@@ -15,18 +15,29 @@
     configuration.  One will generate a 'CS' dll, and the other a 'Game' dll. 
 */
 #include "Submodule/Interface.h"
-#include "Submodule/MyForm.h"
+#include "Submodule/FormRegistry.h"
+#include "Submodule/Settings.h"
+#include "Submodule/WriteBuffer.h"
+#include "Submodule/Trace.h"
+#include "Submodule/ConflictTracker.h"
 
 /*--------------------------------------------------------------------------------------------*/
 // global debugging log for the submodule
 _declspec(dllimport) OutputLog _gLog;
 OutputLog& gLog = _gLog;
 
+/*--------------------------------------------------------------------------------------------*/
+// global activity trace recorder for the submodule (linked to recorder in loader)
+_declspec(dllimport) TraceRecorder _gTrace;
+TraceRecorder& gTrace = _gTrace;
+
 /*--------------------------------------------------------------------------------------------*/
 // global submodule interface
 SubmoduleInterface  g_submoduleIntfc; 
 // module (or "instance") handle - necessary for accessing embedded resources, e.g. dialog templates
 HMODULE hModule = 0;
+// local declaration of command tracing flag defined in interface.cpp
+extern bool g_traceCommands;
 
 /*--------------------------------------------------------------------------------------------*/
 // submodule initialization
@@ -35,8 +46,18 @@ extern "C" _declspec(dllexport) void* Initialize()
     // begin initialization  
     _MESSAGE("Initializing Submodule ..."); 
 
+    // load settings
+    g_traceCommands = GetSettingInt("Trace","Commands",0) != 0;
+    g_extraDataWrites.enabled = GetSettingInt("WriteBuffer","Enabled",0) != 0;
+    g_extraDataWrites.readYourWrites = GetSettingInt("WriteBuffer","ReadYourWrites",1) != 0;
+    g_myFormConflicts.enabled = GetSettingInt("Conflicts","Enabled",0) != 0;
+    g_myFormConflicts.threads = GetSettingInt("Conflicts","Threads",0);
+
+    // format description once, before it can be requested from other threads
+    g_submoduleIntfc.Description();
+
     // Perform hooks & patches
-    MyForm::InitializeMyForm();
+    FormRegistry::RegisterAll(); // register all extended form classes
     
     // initialization complete
     _DMESSAGE("Submodule initialization completed sucessfully");
@@ -0,0 +1,30 @@
+/*
+    High resolution timing helpers
+    Thin wrappers around the windows performance counter, shared by the loader and submodule
+*/
+#pragma once
+
+// returns the current value of the performance counter, in ticks
+inline UInt64 PerfTicks()
+{
+    LARGE_INTEGER ticks;
+    QueryPerformanceCounter(&ticks);
+    return ticks.QuadPart;
+}
+
+// returns the frequency of the performance counter, in ticks per second
+inline UInt64 PerfFrequency()
+{
+    static UInt64 frequency = 0;    // counter frequency is fixed at system boot, so it is cached
+    if (!frequency)
+    {
+        LARGE_INTEGER freq;
+        QueryPerformanceFrequency(&freq);
+        frequency = freq.QuadPart;
+    }
+    return frequency;
+}
+
+// converts a tick count to microseconds / milliseconds
+inline double PerfTicksToUS(UInt64 ticks) { return (double)ticks * 1000000.0 / (double)PerfFrequency(); }
+inline double PerfTicksToMS(UInt64 ticks) { return (double)ticks * 1000.0 / (double)PerfFrequency(); }
@@ -0,0 +1,88 @@
+/*
+    Activity tracing
+    Records begin/end spans of plugin activity (loading & saving forms, script commands, cosave callbacks,
+    OBSE messages, etc.) with microsecond resolution, for diagnosing hitches.  Spans are buffered in memory
+    and written by the loader to a JSON file in the 'trace event' format, which can be viewed with
+    chrome://tracing or Perfetto (ui.perfetto.dev).
+
+    The global trace recorder is owned by the loader, and imported by the submodule (like the global log).
+    Only the inline methods below may be called from the submodule.
+    When tracing is disabled, a TraceScope costs a single predictable branch on entry and on exit.
+*/
+#pragma once
+
+#include "Submodule/Timing.h"
+
+// A single completed span
+struct TraceEvent
+{
+    const char*     name;       // static string
+    const char*     category;   // static string
+    UInt64          start;      // performance counter ticks
+    UInt64          end;        // performance counter ticks
+    UInt32          threadID;
+    UInt32          arg;        // optional argument, e.g. formID or message type
+};
+
+class TraceRecorder
+{
+public:
+    // members
+    bool            enabled;    // if false, nothing is recorded
+
+    // records a span - may be called from any thread
+    inline void     Record(const char* name, const char* category, UInt64 start, UInt64 end, UInt32 arg)
+    {
+        UInt32 index = InterlockedIncrement(&count) - 1;
+        if (index >= capacity) return; // buffer is full, event is dropped
+        TraceEvent& event = events[index];
+        event.name = name;
+        event.category = category;
+        event.start = start;
+        event.end = end;
+        event.threadID = GetCurrentThreadId();
+        event.arg = arg;
+    }
+
+    // loader only
+    void            Enable(UInt32 capacity);    // allocates event buffer & begins recording
+    bool            Flush(const char* path);    // writes all events recorded so far to a trace file
+
+    // constructor
+    TraceRecorder() : enabled(false), events(0), capacity(0), count(0), origin(0) {}
+
+private:
+    TraceEvent*     events;
+    UInt32          capacity;
+    volatile LONG   count;      // number of events recorded, including dropped events
+    UInt64          origin;     // performance counter ticks when recording began
+};
+
+// global trace recorder, defined by the loader
+extern TraceRecorder& gTrace;
+
+// Records the enclosing scope as a span, if tracing is enabled
+class TraceScope
+{
+public:
+    inline TraceScope(const char* name, const char* category, UInt32 arg = 0) : name(0)
+    {
+        if (gTrace.enabled)
+        {
+            this->name = name;
+            this->category = category;
+            this->arg = arg;
+            start = PerfTicks();
+        }
+    }
+    inline ~TraceScope()
+    {
+        if (name) gTrace.Record(name,category,start,PerfTicks(),arg);
+    }
+    inline void SetArg(UInt32 arg) { this->arg = arg; } // e.g. formID, if not known when the span began
+private:
+    const char*     name;
+    const char*     category;
+    UInt32          arg;
+    UInt64          start;
+};
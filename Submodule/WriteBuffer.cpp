@@ -0,0 +1,91 @@
+#include "Submodule/WriteBuffer.h"
+#include "Submodule/MyForm.h"
+#include "Submodule/Snapshot.h"
+
+// local declaration of command tracing flag defined in interface.cpp
+extern bool g_traceCommands;
+
+// marker for a slot whose staged write was discarded; the slot stays occupied until the next commit
+// so that probe sequences through it remain intact
+static MyForm* const kDiscardedForm = (MyForm*)1;
+
+/*--------------------------------------------------------------------------------------------*/
+ExtraDataWriteBuffer g_extraDataWrites;
+
+ExtraDataWriteBuffer::ExtraDataWriteBuffer()
+: enabled(false), readYourWrites(true), usedCount(0)
+{
+    memset(slots,0,sizeof(slots));
+}
+UInt32 ExtraDataWriteBuffer::FindSlot(MyForm* form)
+{
+    // fibonacci hash of the form address, with linear probing
+    // the table is never more than 3/4 full, so the probe always terminates
+    UInt32 index = ((UInt32)(uintptr_t)form * 0x9E3779B9) >> 23; // top 9 bits, for kCapacity = 0x200
+    while (slots[index].form && slots[index].form != form) index = (index + 1) & (kCapacity - 1);
+    return index;
+}
+void ExtraDataWriteBuffer::Write(MyForm* form, UInt32 extraData)
+{
+    if (!enabled)
+    {
+        AtomicStore(form->extraData,extraData);
+        g_myFormSnapshots.MarkChanged();
+        return;
+    }
+    UInt32 index = FindSlot(form);
+    if (!slots[index].form)
+    {
+        // first write to this form since last commit
+        if (usedCount >= kMaxUsed)
+        {
+            Commit();   // buffer is full
+            index = FindSlot(form);
+        }
+        slots[index].form = form;
+        usedSlots[usedCount++] = index;
+    }
+    slots[index].extraData = extraData; // last write wins
+}
+UInt32 ExtraDataWriteBuffer::Read(MyForm* form)
+{
+    if (readYourWrites && usedCount)
+    {
+        UInt32 index = FindSlot(form);
+        if (slots[index].form) return slots[index].extraData; // staged value
+    }
+    return form->extraData; // committed value
+}
+UInt32 ExtraDataWriteBuffer::Latest(MyForm* form)
+{
+    if (usedCount)
+    {
+        UInt32 index = FindSlot(form);
+        if (slots[index].form) return slots[index].extraData; // staged value
+    }
+    return form->extraData; // committed value
+}
+void ExtraDataWriteBuffer::Discard(MyForm* form)
+{
+    if (!usedCount) return;
+    UInt32 index = FindSlot(form);
+    if (slots[index].form) slots[index].form = kDiscardedForm;
+}
+UInt32 ExtraDataWriteBuffer::Commit()
+{
+    UInt32 applied = 0;
+    for (UInt32 i = 0; i < usedCount; i++)
+    {
+        Slot& slot = slots[usedSlots[i]];
+        if (slot.form != kDiscardedForm)
+        {
+            if (g_traceCommands) _MESSAGE("Commit MyFormExtraData ( %08X, %i -> %i )", slot.form->formID, slot.form->extraData, slot.extraData);
+            AtomicStore(slot.form->extraData,slot.extraData);
+            applied++;
+        }
+        slot.form = 0;
+    }
+    usedCount = 0;
+    if (applied) g_myFormSnapshots.MarkChanged();
+    return applied;
+}
@@ -0,0 +1,56 @@
+/*
+    Deferred write buffer for MyForm::extraData
+
+    Writes made by script commands are staged here instead of being applied immediately.  Repeated
+    writes to the same form are coalesced (last write wins), and all staged writes are applied in
+    one pass by Commit().  The loader commits the buffer at well-defined points: before saving,
+    when a game is loaded, on request by the CommitMyFormWrites script command, and whenever the
+    buffer fills up.  There is no end-of-frame commit (OBSE provides no per-frame hook), so until
+    then, code reading MyForm::extraData directly sees the old value.  Staging is therefore opt-in,
+    and disabled by default.
+
+    Staged writes are stored in a small fixed-size open-addressing hash table keyed by form pointer,
+    so staging a write never allocates.
+*/
+#pragma once
+
+class   MyForm;             // Submodule/MyForm.h
+
+class ExtraDataWriteBuffer
+{
+public:
+    // members
+    bool            enabled;        // if false (the default), writes are applied immediately
+    bool            readYourWrites; // if true, reads return staged values before they are committed
+
+    // methods
+    void            Write(MyForm* form, UInt32 extraData);  // stages a write, or applies it immediately if disabled
+    UInt32          Read(MyForm* form);                     // returns the current value of extraData, honoring readYourWrites
+    UInt32          Latest(MyForm* form);                   // returns the staged value of extraData if any, else the committed value
+    void            Discard(MyForm* form);                  // drops any staged write for form, e.g. when it is destroyed
+    UInt32          Commit();                               // applies & clears all staged writes, returns number of writes applied
+    inline UInt32   Count() { return usedCount; }           // number of staged writes (including discarded ones)
+    inline UInt32   MemoryUsage() { return sizeof(*this); } // the buffer is fixed size and never allocates
+
+    // constructor
+    ExtraDataWriteBuffer();
+
+private:
+    static const UInt32 kCapacity   = 0x200;    // must be a power of 2
+    static const UInt32 kMaxUsed    = 0x180;    // commit automatically beyond this load factor
+
+    struct Slot
+    {
+        MyForm*     form;       // zero for an empty slot
+        UInt32      extraData;
+    };
+
+    UInt32          FindSlot(MyForm* form);     // returns index of slot holding form, or of the empty slot where it belongs
+
+    Slot            slots[kCapacity];
+    UInt16          usedSlots[kMaxUsed];        // indices of used slots, in order of first write
+    UInt32          usedCount;
+};
+
+// global write buffer
+extern ExtraDataWriteBuffer g_extraDataWrites;
@@ -0,0 +1,132 @@
+/*
+    Container aggregation: stack merging, and GetMyFormTotals versus a per-stack loop
+    GetMyFormTotals merges the counts listed by a container's base form with the deltas in its
+    ExtraContainerChanges (MergeMyFormStacks), then totals the merged stacks with one AggregateMyForms call.
+    The merge must sum base counts & deltas per form, and drop forms whose items were all removed.
+
+    The benchmark is a native-loop comparison only: the alternative a script would use - one
+    GetMyFormExtraData call per stack plus the engine's weight & value getters, with the histogram in a map -
+    is run as a C++ loop over the direct dispatch table.  It leaves out the script interpreter's per-call
+    dispatch & argument extraction, which dominate the cost of that loop in game, so the reported gap is a
+    lower bound.  Both loops walk the same merged stacks, and must agree.
+*/
+#include "TestHarness.h"
+#include "Submodule/Interface.h"
+#include "Loader/inventory.h"
+
+#include <map>
+
+// local declaration of submodule interface defined in the test harness
+extern SubmoduleInterface* g_submoduleInfc;
+extern const SubmoduleCommandTable* g_submoduleCmds;
+
+static const UInt32 kBaseStacks     = 24;   // stacks listed by the base container
+static const UInt32 kChangedStacks  = 16;   // stacks changed during the game, half of them also in the base container
+static const UInt32 kFormCount      = 0x400;
+
+// base container entries & changes for container c: a window onto forms, the first half of the changes adding
+// to base stacks, the second half adding new forms, and the first base stack emptied
+static void ContainerEntries(UInt32 c, const std::vector<TESForm*>& forms, std::vector<MyFormStack>& entries)
+{
+    UInt32 first = c % kFormCount;
+    entries.clear();
+    for (UInt32 i = 0; i < kBaseStacks; i++) entries.push_back(MyFormStack(forms[(first + i) % kFormCount],(i % 9) + 1));
+    for (UInt32 i = 0; i < kChangedStacks; i++) entries.push_back(MyFormStack(forms[(first + kBaseStacks - kChangedStacks / 2 + i) % kFormCount],2));
+    entries.push_back(MyFormStack(forms[first],-1));
+}
+
+int main(int argc, char* argv[])
+{
+    Test_Initialize();
+    UInt32 containers = Test_Count(argc,argv,100000);
+    std::vector<TESForm*> forms(kFormCount);
+    for (UInt32 i = 0; i < kFormCount; i++)
+    {
+        MyForm* myform = Test_CreateMyForm(0x01000800 + i);
+        myform->goldValue = i % 50;
+        myform->weight = (i % 7) * 0.5f;
+        myform->extraData = i % 5;
+        forms[i] = myform;
+    }
+
+    // merging: base counts plus deltas, in any order; emptied & overdrawn stacks are dropped
+    std::vector<MyFormStack> entries;
+    std::vector<TESForm*> merged;
+    std::vector<SInt32> counts;
+    entries.push_back(MyFormStack(forms[3],-2));    // change to a base stack, listed before it
+    entries.push_back(MyFormStack(forms[0],5));     // base only
+    entries.push_back(MyFormStack(forms[3],4));
+    entries.push_back(MyFormStack(forms[1],3));     // emptied
+    entries.push_back(MyFormStack(forms[1],-3));
+    entries.push_back(MyFormStack(forms[2],1));     // added during the game, twice
+    entries.push_back(MyFormStack(forms[2],1));
+    entries.push_back(MyFormStack(forms[4],-1));    // removed, not in the base container
+    CHECK(MergeMyFormStacks(entries,merged,counts) == 3);
+    std::map<TESForm*,SInt32> byForm;
+    for (UInt32 i = 0; i < merged.size(); i++) byForm[merged[i]] = counts[i];
+    CHECK(byForm.size() == 3 && byForm[forms[0]] == 5 && byForm[forms[2]] == 2 && byForm[forms[3]] == 2);
+    CHECK(MergeMyFormStacks(entries,merged,counts) == 3);   // reordered entries merge the same way
+    entries.clear();
+    CHECK(MergeMyFormStacks(entries,merged,counts) == 0 && merged.empty() && counts.empty());
+
+    // a generated container: kChangedStacks / 2 new forms, and the first base stack emptied
+    ContainerEntries(0,forms,entries);
+    UInt32 stacks = MergeMyFormStacks(entries,merged,counts);
+    CHECK(stacks == kBaseStacks + kChangedStacks / 2 - 1);
+    SInt32 itemCount = 0;
+    for (UInt32 i = 0; i < stacks; i++) itemCount += counts[i];
+    SInt32 expectedCount = kChangedStacks * 2 - 1;
+    for (UInt32 i = 0; i < kBaseStacks; i++) expectedCount += (i % 9) + 1;
+    CHECK(itemCount == expectedCount);
+    MyFormAggregate totals;
+    UInt32 keys[kBaseStacks + kChangedStacks], keyCounts[kBaseStacks + kChangedStacks];
+    UInt32 histogramSize = 0;
+    g_submoduleInfc->AggregateMyForms(&merged[0],&counts[0],stacks,totals,keys,keyCounts,histogramSize);
+    CHECK(totals.stackCount == stacks && totals.itemCount == (UInt32)itemCount);
+
+    // native per-stack loop over the merged stacks, histogram in a map
+    double loopWeight = 0, loopValue = 0;
+    UInt64 loopHistogram = 0;
+    UInt64 start = PerfTicks();
+    for (UInt32 c = 0; c < containers; c++)
+    {
+        ContainerEntries(c,forms,entries);
+        stacks = MergeMyFormStacks(entries,merged,counts);
+        double weight = 0, value = 0;
+        std::map<UInt32,UInt32> histogram;
+        for (UInt32 s = 0; s < stacks; s++)
+        {
+            TESForm* form = merged[s];
+            if (form->GetFormType() != g_submoduleCmds->myFormType) continue;
+            UInt32 extraData = g_submoduleCmds->GetMyFormExtraData(form);
+            weight += (double)((MyForm*)form)->weight * counts[s];
+            value += (double)((MyForm*)form)->goldValue * counts[s];
+            histogram[extraData] += counts[s];
+        }
+        loopWeight += weight;
+        loopValue += value;
+        loopHistogram += histogram.size();
+    }
+    UInt64 loopTicks = PerfTicks() - start;
+
+    // GetMyFormTotals: merge, then one AggregateMyForms call per container
+    double totalWeight = 0, totalValue = 0;
+    UInt64 totalHistogram = 0;
+    start = PerfTicks();
+    for (UInt32 c = 0; c < containers; c++)
+    {
+        ContainerEntries(c,forms,entries);
+        stacks = MergeMyFormStacks(entries,merged,counts);
+        g_submoduleInfc->AggregateMyForms(&merged[0],&counts[0],stacks,totals,keys,keyCounts,histogramSize);
+        totalWeight += totals.totalWeight;
+        totalValue += totals.totalValue;
+        totalHistogram += histogramSize;
+    }
+    UInt64 totalTicks = PerfTicks() - start;
+    CHECK(totalWeight == loopWeight && totalValue == loopValue && totalHistogram == loopHistogram);
+
+    Test_Bench("native per-stack loop (no script overhead), 31 stacks",containers,"container",loopTicks);
+    Test_Bench("GetMyFormTotals, 31 stacks",containers,"container",totalTicks);
+    Test_DestroyMyForms();
+    return Test_Result("AggregateBench");
+}
@@ -0,0 +1,124 @@
+/*
+    Columnar export: export & scan throughput, and reader validation
+    All MyForms are exported to a columnar file, which is then mapped and scanned in place through
+    MyFormColumnsReader, and checked against the forms.  The reader must reject files whose descriptors
+    disagree with the format: element widths other than the column's type, a row count whose array size
+    overflows, and a column described twice.
+*/
+#include "TestHarness.h"
+#include "Submodule/MyFormColumns.h"
+#include "Submodule/Interface.h"
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <string>
+
+// local declaration of submodule interface defined in the test harness
+extern SubmoduleInterface g_submoduleIntfc;
+
+int main(int argc, char* argv[])
+{
+    Test_Initialize();
+    UInt32 count = Test_Count(argc,argv,1000000);
+
+    // forms, every 16th with an EditorID
+    SInt64 expectedValue = 0;
+    double expectedWeight = 0;
+    UInt32 expectedExtraData = 0, expectedEditorIDs = 0;
+    char editorID[0x40];
+    for (UInt32 i = 0; i < count; i++)
+    {
+        sprintf_s(editorID,sizeof(editorID),"ColumnForm%07u",i);
+        MyForm* myform = Test_CreateMyForm(0x01000800 + i,(i % 16) ? 0 : editorID);
+        myform->goldValue = i % 1000;
+        myform->weight = (i % 10) * 0.25f;
+        myform->extraData = i % 3;
+        expectedValue += myform->goldValue;
+        expectedWeight += myform->weight;
+        expectedExtraData += myform->extraData != 0;
+        expectedEditorIDs += (i % 16) == 0;
+    }
+
+    // export
+    char path[] = "/tmp/ColumnExportBenchXXXXXX";
+    int descriptor = mkstemp(path);
+    if (descriptor >= 0) close(descriptor);
+    UInt64 start = PerfTicks();
+    CHECK(g_submoduleIntfc.ExportMyFormColumns(path));
+    UInt64 exportTicks = PerfTicks() - start;
+
+    // map & scan in place
+    descriptor = open(path,O_RDONLY);
+    struct stat info;
+    CHECK(descriptor >= 0 && fstat(descriptor,&info) == 0);
+    UInt32 fileSize = info.st_size;
+    const char* mapped = (const char*)mmap(0,fileSize,PROT_READ,MAP_PRIVATE,descriptor,0);
+    CHECK(mapped != MAP_FAILED);
+    start = PerfTicks();
+    MyFormColumnsReader reader;
+    bool opened = reader.Open(mapped,fileSize);
+    SInt64 value = 0;
+    double weight = 0;
+    UInt32 extraData = 0, editorIDs = 0, ordered = 0;
+    if (opened)
+    {
+        const UInt32* formIDs = reader.FormIDs();
+        const int* values = reader.Values();
+        const float* weights = reader.Weights();
+        const UInt32* extra = reader.ExtraData();
+        for (UInt32 r = 0; r < reader.RowCount(); r++)
+        {
+            ordered += r == 0 || formIDs[r] > formIDs[r - 1];
+            value += values[r];
+            weight += weights[r];
+            extraData += extra[r] != 0;
+            editorIDs += *reader.String(MyFormColumnDesc::kColumn_EditorID,r) != 0;
+        }
+    }
+    UInt64 scanTicks = PerfTicks() - start;
+    CHECK(opened && reader.RowCount() == count && ordered == count);
+    CHECK(value == expectedValue && weight == expectedWeight);
+    CHECK(extraData == expectedExtraData && editorIDs == expectedEditorIDs);
+    CHECK(opened && strcmp(reader.String(MyFormColumnDesc::kColumn_EditorID,16),"ColumnForm0000016") == 0);
+
+    // malformed descriptors, on a copy of the file
+    std::vector<char> copy(mapped,mapped + fileSize);
+    munmap((void*)mapped,fileSize);
+    close(descriptor);
+    remove(path);
+    MyFormColumnsHeader* header = (MyFormColumnsHeader*)&copy[0];
+    MyFormColumnDesc* descs = (MyFormColumnDesc*)(header + 1);
+    CHECK(reader.Open(&copy[0],copy.size()));
+    MyFormColumnDesc& types = descs[MyFormColumnDesc::kColumn_FormType];
+    types.elementSize = 4;  // form types read as 4-byte values, running into the following columns
+    types.size = count * 4;
+    CHECK(!reader.Open(&copy[0],copy.size()));
+    header->rowCount = count + 0x40000000;  // rowCount * 4 wraps around to the size of every 4-byte column
+    CHECK(!reader.Open(&copy[0],copy.size()));
+    types.elementSize = 1;
+    types.size = count;
+    CHECK(!reader.Open(&copy[0],copy.size()));
+    header->rowCount = count;
+    CHECK(reader.Open(&copy[0],copy.size()));
+
+    // a second descriptor for the value column, pointing at extraData, with all other columns present
+    UInt32 tableEnd = sizeof(MyFormColumnsHeader) + header->columnCount * sizeof(MyFormColumnDesc);
+    std::vector<char> duplicate(copy.begin(),copy.begin() + tableEnd);
+    MyFormColumnDesc extra = descs[MyFormColumnDesc::kColumn_ExtraData];
+    extra.column = MyFormColumnDesc::kColumn_Value;
+    duplicate.insert(duplicate.end(),(char*)&extra,(char*)(&extra + 1));
+    duplicate.insert(duplicate.end(),copy.begin() + tableEnd,copy.end());
+    header = (MyFormColumnsHeader*)&duplicate[0];
+    descs = (MyFormColumnDesc*)(header + 1);
+    header->columnCount++;
+    for (UInt32 c = 0; c < header->columnCount; c++) descs[c].offset += sizeof(MyFormColumnDesc);
+    CHECK(!reader.Open(&duplicate[0],duplicate.size()));
+    header->columnCount--;  // the same file without the duplicate
+    CHECK(reader.Open(&duplicate[0],duplicate.size()));
+
+    Test_Bench("Export MyForm columns",count,"form",exportTicks);
+    Test_Bench("Open & scan mapped columns",count,"row",scanTicks);
+    Test_DestroyMyForms();
+    return Test_Result("ColumnExportBench");
+}
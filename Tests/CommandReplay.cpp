@@ -0,0 +1,106 @@
+/*
+    Standalone script command replay
+    Replays a command recording (see Loader/recorder.h) against a stand-in form store, outside the game:
+        CommandReplay [recording]
+    Every MyForm the recording refers to is created in the stand-in form list first, so all calls resolve,
+    and the log (including the latency percentiles logged by ReplayCommandRecording) is printed to stdout.
+    Without a recording, a synthetic workload is recorded through the command recorder and replayed, which
+    is what CTest runs; the replay must execute every call and leave extraData as it found it.
+*/
+#include "TestHarness.h"
+#include "Loader/recorder.h"
+#include "Submodule/Interface.h"
+
+#include <set>
+
+// local declaration of submodule interface & direct dispatch table defined in the test harness
+extern SubmoduleInterface* g_submoduleInfc;
+extern const SubmoduleCommandTable* g_submoduleCmds;
+
+// prints log messages, so the replay's latency report is visible; verbose & debug output is dropped
+class StdoutTarget : public OutputTarget
+{
+public:
+    virtual void WriteOutputLine(const OutputStyle& style, time_t time, int channel, const char* source, const char* text)
+    {
+        if (channel <= 3) printf("%s\n",text);
+    }
+};
+
+static const UInt32 kWorkloadCalls  = 100000;
+static const UInt32 kWorkloadForms  = 0x400;
+
+// creates the MyForms referenced by a recording, returns the number of calls in it (or -1)
+static SInt32 CreateFormStore(const char* path)
+{
+    FILE* file = 0;
+    if (fopen_s(&file,path,"rb") != 0 || !file) return -1;
+    CommandRecorder::RecordingHeader header;
+    SInt32 calls = -1;
+    std::set<UInt32> formIDs;
+    if (fread(&header,sizeof(header),1,file) == 1 && header.magic == CommandRecorder::RecordingHeader::kMagic)
+    {
+        CommandRecorder::CallRecord record;
+        for (calls = 0; fread(&record,sizeof(record),1,file) == 1; calls++) if (record.formID) formIDs.insert(record.formID);
+    }
+    fclose(file);
+    for (std::set<UInt32>::iterator it = formIDs.begin(); it != formIDs.end(); ++it) Test_CreateMyForm(*it);
+    return calls;
+}
+
+int main(int argc, char* argv[])
+{
+    Test_Initialize();
+
+    // replay a recording from the command line
+    if (argc > 1)
+    {
+        StdoutTarget target;
+        gLog.AttachTarget(target);
+        SInt32 calls = CreateFormStore(argv[1]);
+        if (calls < 0)
+        {
+            gLog.DetachTarget(target);
+            fprintf(stderr,"'%s' is not a command recording\n",argv[1]);
+            return 1;
+        }
+        SInt32 replayed = ReplayCommandRecording(argv[1]);
+        gLog.DetachTarget(target);
+        Test_DestroyMyForms();
+        return replayed == calls ? 0 : 1;
+    }
+
+    // record a synthetic workload: mostly reads, some writes, the occasional listing
+    char path[] = "/tmp/CommandReplayXXXXXX";
+    int descriptor = mkstemp(path);
+    if (descriptor >= 0) close(descriptor);
+    g_commandRecorder.Enable(path,0x1000);
+    CHECK(g_commandRecorder.enabled);
+    for (UInt32 i = 0; i < kWorkloadCalls; i++)
+    {
+        UInt32 formID = 0x01000800 + (i * 0x9E3779B1) % kWorkloadForms;
+        if (i % 10000 == 0) g_commandRecorder.Record(CommandRecorder::kOpcode_ListMyForms,0,0);
+        else if (i % 8 == 0) g_commandRecorder.Record(CommandRecorder::kOpcode_SetMyFormExtraData,formID,i);
+        else g_commandRecorder.Record(CommandRecorder::kOpcode_GetMyFormExtraData,formID,0);
+    }
+    g_commandRecorder.Flush();
+
+    // replay it against the stand-in form store
+    CHECK(CreateFormStore(path) == (SInt32)kWorkloadCalls);
+    TESForm* const* forms = 0;
+    UInt32 count = g_submoduleInfc->GetMyFormsInRange(0,0xFFFFFFFF,forms);
+    CHECK(count == kWorkloadForms);
+    for (UInt32 i = 0; i < count; i++) g_submoduleCmds->SetMyFormExtraData(forms[i],i);
+    g_submoduleInfc->CommitMyFormWrites();
+    UInt64 start = PerfTicks();
+    CHECK(ReplayCommandRecording(path) == (SInt32)kWorkloadCalls);
+    UInt64 replayTicks = PerfTicks() - start;
+    UInt32 restored = 0;
+    for (UInt32 i = 0; i < count; i++) restored += g_submoduleCmds->GetMyFormExtraData(forms[i]) == i;
+    CHECK(restored == count);
+
+    remove(path);
+    Test_Bench("Replay recorded commands",kWorkloadCalls,"call",replayTicks);
+    Test_DestroyMyForms();
+    return Test_Result("CommandReplay");
+}
@@ -0,0 +1,161 @@
+/*
+    Record compression: size & throughput of the plugin compression pass
+    A plugin of MyForm records saved by SaveFormChunks(), most with long descriptions, is compressed;
+    every record must load back with the same fields, and records below the threshold, records of other
+    types, and malformed plugins must be left as they are.
+*/
+#include "TestHarness.h"
+#include "Submodule/RecordCompression.h"
+#include "Submodule/Interface.h"
+#include "API/TESFiles/TESFile.h"
+
+// local declaration of submodule interface defined in the test harness
+extern SubmoduleInterface* g_submoduleInfc;
+
+static void AppendHeader(std::vector<UInt8>& plugin, const char* type, UInt32 size, UInt32 flags, UInt32 formID)
+{
+    UInt32 header[5] = { 0, size, flags, formID, 0 };
+    memcpy(&header[0],type,4);
+    plugin.insert(plugin.end(),(UInt8*)header,(UInt8*)header + sizeof(header));
+}
+
+// splits a plugin into its MyForm records, returns false if a group or record is malformed
+static bool ListRecords(const std::vector<UInt8>& plugin, std::vector<UInt32>& offsets)
+{
+    UInt32 offset = 0;
+    while (offset + 20 <= plugin.size())
+    {
+        UInt32 size;
+        memcpy(&size,&plugin[offset + 4],4);
+        if (!memcmp(&plugin[offset],"GRUP",4)) { offset += 20; continue; }  // records follow the group header
+        if (!memcmp(&plugin[offset],MYFORM_SHORTNAME,4)) offsets.push_back(offset);
+        offset += 20 + size;
+    }
+    return offset == plugin.size();
+}
+
+int main(int argc, char* argv[])
+{
+    Test_Initialize();
+    UInt32 count = Test_Count(argc,argv,10000);
+    const UInt32 kRecordType = *(const UInt32*)MYFORM_SHORTNAME;
+
+    // save a plugin: TES4 header, then a group of MyForms with one record of another type
+    std::vector<UInt8> plugin;
+    AppendHeader(plugin,"TES4",0,0,0);
+    UInt32 group = plugin.size();
+    AppendHeader(plugin,"GRUP",0,kRecordType,0);
+    TESFile saveFile("Compressed.esp");
+    TESFile::activeFile = &saveFile;
+    std::vector<MyForm*> saved;
+    char editorID[0x40], description[0x1000];
+    for (UInt32 i = 0; i < count; i++)
+    {
+        MyForm* myform = Test_CreateMyForm(0x01000800 + i);
+        sprintf_s(editorID,sizeof(editorID),"CompressedForm%05u",i);
+        myform->SetEditorID(editorID);
+        myform->name.Set("Compressed Form");
+        myform->goldValue = i;
+        myform->weight = i * 0.5f;
+        myform->extraData = i * 7;
+        description[0] = 0;
+        UInt32 lines = (i % 4) ? 24 : 1;    // every fourth record stays below the threshold
+        for (UInt32 n = 0; n < lines; n++)
+        {
+            size_t length = strlen(description);
+            sprintf_s(description + length,sizeof(description) - length,"Line %u of the description of form %u. ",n,i);
+        }
+        myform->SetDescription(description);
+        myform->SaveFormChunks();
+        saved.push_back(myform);
+    }
+    TESFile::activeFile = 0;
+    plugin.insert(plugin.end(),saveFile.saved.begin(),saveFile.saved.end());
+    static const char other[] = "DATA\x04\x00\x01\x02\x03\x04";
+    AppendHeader(plugin,"MISC",sizeof(other) - 1,0,0x01000001);
+    plugin.insert(plugin.end(),(const UInt8*)other,(const UInt8*)other + sizeof(other) - 1);
+    UInt32 groupSize = plugin.size() - group;
+    memcpy(&plugin[group + 4],&groupSize,4);
+
+    // compress
+    std::vector<UInt8> result;
+    RecordCompressionStats stats;
+    UInt64 start = PerfTicks();
+    CHECK(RecordCompression::CompressPlugin(plugin,result,kRecordType,MyForm::compressionThreshold,stats));
+    UInt64 compressTicks = PerfTicks() - start;
+    CHECK(stats.records == count);
+    CHECK(stats.compressed > 0 && stats.compressed <= count - (count + 3) / 4);
+    CHECK(stats.packedBytes < stats.rawBytes);
+    CHECK(result.size() < plugin.size());
+    UInt32 resultGroupSize;
+    memcpy(&resultGroupSize,&result[group + 4],4);
+    CHECK(resultGroupSize == result.size() - group);
+    CHECK(!memcmp(&result[result.size() - 20 - sizeof(other) + 1],"MISC",4));
+
+    // every record loads back with the same fields, compressed or not
+    std::vector<UInt32> offsets;
+    CHECK(ListRecords(result,offsets) && offsets.size() == count);
+    UInt32 compressed = 0, matched = 0;
+    MyForm* loaded = (MyForm*)MyForm::CreateMyForm();
+    start = PerfTicks();
+    for (UInt32 i = 0; i < offsets.size() && i < count; i++)
+    {
+        UInt32 size;
+        memcpy(&size,&result[offsets[i] + 4],4);
+        TESFile file("Compressed.esp",&result[offsets[i]],20 + size);
+        loaded->LoadForm(file);
+        if (loaded->formFlags & RecordCompression::kFormFlags_Compressed) compressed++;
+        MyForm* original = saved[i];
+        if (loaded->formID == original->formID && !strcmp(loaded->GetEditorID(),original->GetEditorID()) &&
+            !strcmp(loaded->GetDescription(loaded,Swap32('DESC')),original->GetDescription(original,Swap32('DESC'))) &&
+            loaded->goldValue == original->goldValue && loaded->weight == original->weight &&
+            loaded->extraData == original->extraData) matched++;
+    }
+    UInt64 loadTicks = PerfTicks() - start;
+    delete loaded;
+    CHECK(compressed == stats.compressed);
+    CHECK(matched == count);
+
+    // a second pass finds nothing left to compress
+    std::vector<UInt8> again;
+    RecordCompressionStats againStats;
+    CHECK(RecordCompression::CompressPlugin(result,again,kRecordType,MyForm::compressionThreshold,againStats));
+    CHECK(againStats.compressed == 0 && again == result);
+
+    // malformed plugins are rejected
+    std::vector<UInt8> truncated(plugin.begin(),plugin.end() - 3);
+    CHECK(!RecordCompression::CompressPlugin(truncated,again,kRecordType,MyForm::compressionThreshold,againStats));
+    std::vector<UInt8> oversized(plugin);
+    UInt32 hugeSize = 0x7FFFFFFF;
+    memcpy(&oversized[group + 4],&hugeSize,4);
+    CHECK(!RecordCompression::CompressPlugin(oversized,again,kRecordType,MyForm::compressionThreshold,againStats));
+    std::vector<UInt8> packed, body;
+    CHECK(RecordCompression::Deflate(&plugin[0],plugin.size(),packed));
+    packed[packed.size() / 2] ^= 0xFF;
+    CHECK(!RecordCompression::Inflate(&packed[0],packed.size(),body));
+
+    // the plugin file is rewritten in place through the submodule interface
+    char path[] = "/tmp/CompressionBenchXXXXXX";
+    int descriptor = mkstemp(path);
+    CHECK(descriptor >= 0);
+    FILE* file = fdopen(descriptor,"wb");
+    fwrite(&plugin[0],1,plugin.size(),file);
+    fclose(file);
+    CHECK(g_submoduleInfc->CompressMyFormRecords(path) == (SInt32)stats.compressed);
+    std::vector<UInt8> rewritten(result.size() + 1);
+    fopen_s(&file,path,"rb");
+    CHECK(file && fread(&rewritten[0],1,rewritten.size(),file) == result.size());
+    if (file) fclose(file);
+    rewritten.resize(result.size());
+    CHECK(rewritten == result);
+    remove(path);
+    CHECK(g_submoduleInfc->CompressMyFormRecords(path) < 0);
+
+    printf("MyForm records: %u of %u compressed, %u -> %u bytes (%.1f%%), plugin %u -> %u bytes\n",
+        stats.compressed,stats.records,stats.rawBytes,stats.packedBytes,
+        stats.rawBytes ? 100.0 * stats.packedBytes / stats.rawBytes : 0.0,(UInt32)plugin.size(),(UInt32)result.size());
+    Test_Bench("Compress plugin",plugin.size() / 1024,"KB",compressTicks);
+    Test_Bench("Load compressed records",count,"record",loadTicks);
+    Test_DestroyMyForms();
+    return Test_Result("CompressionBench");
+}
@@ -0,0 +1,87 @@
+/*
+    Load order conflict detection
+    Versions of MyForms are loaded from several files as the engine would, one file after another, and the
+    report must flag exactly the forms whose overrides disagree - including an override that restores the
+    master value over an earlier override.  Analysis throughput is reported for many overridden forms.
+*/
+#include "TestHarness.h"
+#include "Submodule/ConflictTracker.h"
+#include "API/TESFiles/TESFile.h"
+
+#include <string>
+
+// creates a form, as the engine does when the first file with its record is loaded
+static MyForm* CreateForm(UInt32 formID)
+{
+    MyForm* form = (MyForm*)MyForm::CreateMyForm();
+    form->formID = formID;
+    MyForm::extendedForm.AddToFormList(form);
+    return form;
+}
+// loads a version of form from the named file, with the specified extraData
+static void LoadVersion(MyForm* form, const char* fileName, UInt32 extraData)
+{
+    std::vector<UInt8> record = Test_MyFormRecord(form->formID,0,extraData);
+    TESFile file(fileName,&record[0],record.size());
+    form->LoadForm(file);
+}
+static std::string Report(SInt32& conflicting)
+{
+    char path[] = "/tmp/ConflictTrackerTestXXXXXX";
+    int descriptor = mkstemp(path);
+    if (descriptor >= 0) close(descriptor);
+    conflicting = g_myFormConflicts.Report(path);
+    std::string contents;
+    FILE* file = 0;
+    if (fopen_s(&file,path,"r") == 0 && file)
+    {
+        char buffer[0x1000];
+        for (size_t read; (read = fread(buffer,1,sizeof(buffer),file)) > 0;) contents.append(buffer,read);
+        fclose(file);
+    }
+    remove(path);
+    return contents;
+}
+
+int main(int argc, char* argv[])
+{
+    Test_Initialize();
+    UInt32 count = Test_Count(argc,argv,100000);
+    g_myFormConflicts.enabled = true;
+
+    // master=1, A=2, B=1: B reverts A, so the load order decides - a conflict
+    MyForm* reverted = CreateForm(0x01000800);
+    // master=1, A=2, B=2: both overrides agree - overridden, no conflict
+    MyForm* agreed = CreateForm(0x01000801);
+    // master=1, A=1, B=2: a single override - overridden, no conflict
+    MyForm* single = CreateForm(0x01000802);
+    // master=1, A=2, B=3: a conflict
+    MyForm* diverged = CreateForm(0x01000803);
+    const char* files[3] = { "Master.esm", "A.esp", "B.esp" };
+    const UInt32 values[4][3] = { { 1, 2, 1 }, { 1, 2, 2 }, { 1, 1, 2 }, { 1, 2, 3 } };
+    MyForm* forms[4] = { reverted, agreed, single, diverged };
+    for (UInt32 f = 0; f < 3; f++) for (UInt32 i = 0; i < 4; i++) LoadVersion(forms[i],files[f],values[i][f]);
+
+    SInt32 conflicting = 0;
+    std::string report = Report(conflicting);
+    CHECK(conflicting == 2);
+    CHECK(report.find("01000800 '': extraData* [Master.esm, +A.esp, +B.esp]") != std::string::npos);
+    CHECK(report.find("01000801 '': extraData [Master.esm, +A.esp, B.esp]") != std::string::npos);
+    CHECK(report.find("01000802 '': extraData [Master.esm, A.esp, +B.esp]") != std::string::npos);
+    CHECK(report.find("01000803 '': extraData* [Master.esm, +A.esp, +B.esp]") != std::string::npos);
+
+    // analysis of many overridden forms, a quarter of them in conflict; files are loaded one after another
+    std::vector<MyForm*> bulk(count);
+    for (UInt32 i = 0; i < count; i++) bulk[i] = CreateForm(0x02000800 + i);
+    for (UInt32 i = 0; i < count; i++) LoadVersion(bulk[i],"Master.esm",0);
+    for (UInt32 i = 0; i < count; i++) LoadVersion(bulk[i],"A.esp",1);
+    for (UInt32 i = 0; i < count; i++) LoadVersion(bulk[i],"B.esp",(i & 3) ? 1 : 0);
+    UInt64 start = PerfTicks();
+    Report(conflicting);
+    UInt64 reportTicks = PerfTicks() - start;
+    CHECK(conflicting == 2 + (SInt32)((count + 3) / 4));
+
+    Test_Bench("Analyze & report overridden forms",count,"form",reportTicks);
+    Test_DestroyMyForms();
+    return Test_Result("ConflictTrackerTest");
+}
@@ -0,0 +1,53 @@
+/*
+    CSE console output throughput
+    Log lines are sent to a stand-in CSE console through the batching console target, and the number of
+    PrintToConsole calls (each of which redraws the real console) is compared to the number of lines.
+*/
+#include "TestHarness.h"
+#include "Loader/targets.h"
+#include "Submodule/CSE_Interface.h"
+
+// local declaration of CSE console interface defined in the test harness
+extern CSEConsoleInterface* g_cseConsoleInfc;
+
+static UInt32 s_printCalls = 0;
+static UInt32 s_printedLines = 0;
+static UInt32 s_printedBytes = 0;
+static bool   s_chunksValid = true;
+
+static void PrintToConsole(const char* prefix, const char* message)
+{
+    // the loader passes the prefix first, as CSE expects
+    s_printCalls++;
+    UInt32 length = strlen(message);
+    if (length >= CSEConsoleTarget::kChunkSize || strcmp(prefix,SOLUTIONNAME)) s_chunksValid = false;
+    s_printedBytes += length;
+    s_printedLines++;
+    for (const char* c = message; *c; c++) if (*c == '\n') s_printedLines++;
+}
+
+int main(int argc, char* argv[])
+{
+    UInt32 count = Test_Count(argc,argv,200000);
+    CSEConsoleInterface console;
+    memset(&console,0,sizeof(console));
+    console.PrintToConsole = &PrintToConsole;
+    g_cseConsoleInfc = &console;
+    _CSETarget.consoleStyle.includeTime = _CSETarget.consoleStyle.includeSource = false;
+    gLog.AttachTarget(_CSETarget);
+
+    UInt64 start = PerfTicks();
+    for (UInt32 i = 0; i < count; i++) _MESSAGE("MyForm %08X: name='Example Form %u', weight=%f, value=%i",0x01000800 + i,i,1.5,i);
+    _CSETarget.Flush();
+    UInt64 ticks = PerfTicks() - start;
+    gLog.DetachTarget(_CSETarget);
+
+    CHECK(s_printedLines == count);
+    CHECK(s_chunksValid);
+    // every chunk but the last is nearly full, so there is roughly one call per chunk of text
+    CHECK(s_printCalls <= s_printedBytes / (CSEConsoleTarget::kChunkSize / 2) + 1);
+
+    Test_Bench("log to CSE console",count,"line",ticks);
+    printf("%u PrintToConsole calls, %.1f lines per call\n",s_printCalls,s_printCalls ? (double)count / s_printCalls : 0.0);
+    return Test_Result("ConsoleBench");
+}
@@ -0,0 +1,32 @@
+/*
+    MyForm construction throughput
+    Every MyForm loaded from a plugin or cloned in the CS is constructed & destroyed through the same path,
+    so the per-instance cost of the constructor (statistics & index bookkeeping) is measured here, along
+    with a check that registration no longer constructs a prototype instance.
+*/
+#include "TestHarness.h"
+
+int main(int argc, char* argv[])
+{
+    Test_Initialize();
+    UInt32 count = Test_Count(argc,argv,200000);
+
+    // the class descriptor supplies its vtbl, without any instance being created
+    CHECK(MyForm::classInfo.vtbl != 0);
+    CHECK(MyForm::classInfo.instanceCount == 0);
+
+    std::vector<TESForm*> forms(count);
+    UInt64 start = PerfTicks();
+    for (UInt32 i = 0; i < count; i++) forms[i] = MyForm::CreateMyForm();
+    UInt64 constructTicks = PerfTicks() - start;
+    CHECK(MyForm::classInfo.instanceCount == (SInt32)count);
+
+    start = PerfTicks();
+    for (UInt32 i = 0; i < count; i++) delete forms[i];
+    UInt64 destroyTicks = PerfTicks() - start;
+    CHECK(MyForm::classInfo.instanceCount == 0);
+
+    Test_Bench("construct MyForm",count,"form",constructTicks);
+    Test_Bench("destroy MyForm",count,"form",destroyTicks);
+    return Test_Result("ConstructionBench");
+}
@@ -0,0 +1,156 @@
+/*
+    Cosave persistence of extraData, through an in-memory serialization interface
+    Values saved in the 'XDAT' record must be applied to the same forms on load, with mod indices remapped
+    for the new load order and forms of unloaded mods dropped; malformed records and records of unknown
+    versions must be ignored.  Save, game thread load time & decoding thread time are reported.
+*/
+#include "TestHarness.h"
+#include "Loader/cosave.h"
+#include "Submodule/Interface.h"
+#include "obse/PluginAPI.h"
+
+// local declarations of submodule & serialization interfaces defined in the test harness
+extern SubmoduleInterface g_submoduleIntfc;
+extern OBSESerializationInterface* g_serializationIntfc;
+
+/*--------------------------------------------------------------------------------------------*/
+// in-memory cosave
+struct Record
+{
+    UInt32              type;
+    UInt32              version;
+    std::vector<UInt8>  data;
+};
+static std::vector<Record>  s_records;
+static UInt32               s_nextRecord = 0;   // next record to be read
+static SInt32               s_modIndexMap[0x100];   // saved mod index -> loaded mod index, or -1 if not loaded
+
+static bool OpenRecord(UInt32 type, UInt32 version)
+{
+    Record record = { type, version };
+    s_records.push_back(record);
+    return true;
+}
+static bool WriteRecordData(const void* buf, UInt32 length)
+{
+    if (s_records.empty()) return false;
+    std::vector<UInt8>& data = s_records.back().data;
+    data.insert(data.end(),(const UInt8*)buf,(const UInt8*)buf + length);
+    return true;
+}
+static bool GetNextRecordInfo(UInt32* type, UInt32* version, UInt32* length)
+{
+    if (s_nextRecord >= s_records.size()) return false;
+    const Record& record = s_records[s_nextRecord++];
+    *type = record.type;
+    *version = record.version;
+    *length = record.data.size();
+    return true;
+}
+static UInt32 ReadRecordData(void* buf, UInt32 length)
+{
+    const Record& record = s_records[s_nextRecord - 1];
+    if (length > record.data.size()) length = record.data.size();
+    memcpy(buf,record.data.empty() ? 0 : &record.data[0],length);
+    return length;
+}
+static bool ResolveRefID(UInt32 refID, UInt32* outRefID)
+{
+    if (s_modIndexMap[refID >> 24] < 0) return false;
+    *outRefID = (refID & 0x00FFFFFF) | (s_modIndexMap[refID >> 24] << 24);
+    return true;
+}
+static OBSESerializationInterface s_serialization = { &OpenRecord, &WriteRecordData, &GetNextRecordInfo, &ReadRecordData, &ResolveRefID };
+
+static void Load()
+{
+    s_nextRecord = 0;
+    g_extraDataCosave.Preload();
+    s_nextRecord = 0;
+    g_extraDataCosave.Apply();
+}
+static void ClearExtraData(std::vector<MyForm*>& forms)
+{
+    for (UInt32 i = 0; i < forms.size(); i++) forms[i]->extraData = 0;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+int main(int argc, char* argv[])
+{
+    Test_Initialize();
+    UInt32 count = Test_Count(argc,argv,100000);
+    g_serializationIntfc = &s_serialization;
+    for (UInt32 i = 0; i < 0x100; i++) s_modIndexMap[i] = i;
+
+    // forms in mods 1-4, with the same low formIDs in each
+    std::vector<MyForm*> forms(count);
+    for (UInt32 i = 0; i < count; i++)
+    {
+        forms[i] = Test_CreateMyForm((((i & 3) + 1) << 24) | (0x800 + i / 4));
+        forms[i]->extraData = i + 1;
+    }
+    g_submoduleIntfc.CommitMyFormWrites();  // publishes, as before saving
+
+    // save
+    UInt64 start = PerfTicks();
+    g_extraDataCosave.Save();
+    UInt64 saveTicks = PerfTicks() - start;
+    CHECK(s_records.size() == 1 && s_records[0].type == ExtraDataCosave::kRecordType);
+    CHECK(s_records[0].data.size() == sizeof(UInt32) + count * 2 * sizeof(UInt32));
+
+    // load into the same load order
+    ClearExtraData(forms);
+    start = PerfTicks();
+    Load();
+    UInt64 loadTicks = PerfTicks() - start;
+    UInt32 restored = 0;
+    for (UInt32 i = 0; i < count; i++) if (forms[i]->extraData == i + 1) restored++;
+    CHECK(restored == count);
+
+    // mods 1 & 2 swapped, mod 4 no longer loaded
+    std::tr1::unordered_map<UInt32,UInt32> saved;   // formID -> saved extraData
+    for (UInt32 i = 0; i < count; i++) saved[forms[i]->formID] = i + 1;
+    ClearExtraData(forms);
+    s_modIndexMap[1] = 2;
+    s_modIndexMap[2] = 1;
+    s_modIndexMap[4] = -1;
+    Load();
+    UInt32 remapped = 0;
+    for (UInt32 i = 0; i < count; i++)
+    {
+        UInt32 modIndex = forms[i]->formID >> 24;
+        UInt32 savedModIndex = (modIndex == 1) ? 2 : (modIndex == 2) ? 1 : modIndex;
+        std::tr1::unordered_map<UInt32,UInt32>::iterator it = saved.find((forms[i]->formID & 0x00FFFFFF) | (savedModIndex << 24));
+        UInt32 expected = (modIndex == 4 || it == saved.end()) ? 0 : it->second;  // nothing is loaded into mod 4's slot
+        if (forms[i]->extraData == expected) remapped++;
+    }
+    CHECK(remapped == count);
+    for (UInt32 i = 0; i < 0x100; i++) s_modIndexMap[i] = i;
+
+    // malformed records & unknown versions are ignored, and leave extraData untouched
+    ClearExtraData(forms);
+    s_records[0].data.resize(s_records[0].data.size() - 1);
+    Load();
+    s_records[0].data.resize(s_records[0].data.size() + 1);
+    s_records[0].version = ExtraDataCosave::kRecordVersion + 1;
+    Load();
+    UInt32 untouched = 0;
+    for (UInt32 i = 0; i < count; i++) untouched += forms[i]->extraData == 0;
+    CHECK(untouched == count);
+
+    // the last valid record wins
+    s_records[0].version = ExtraDataCosave::kRecordVersion;
+    g_submoduleIntfc.SetMyFormExtraData(forms[0],0x1234);
+    g_submoduleIntfc.CommitMyFormWrites();
+    g_extraDataCosave.Save();
+    CHECK(s_records.size() == 2);
+    forms[0]->extraData = 0;
+    Load();
+    CHECK(forms[0]->extraData == 0x1234);
+
+    Test_Bench("Save extraData",count,"form",saveTicks);
+    Test_Bench("Load extraData (preload, decode & apply)",count,"form",loadTicks);
+    g_serializationIntfc = 0;
+    Test_DestroyMyForms();
+    return Test_Result("CosaveTest");
+}
@@ -0,0 +1,60 @@
+/*
+    Script command dispatch throughput
+    Compares the virtual SubmoduleInterface methods (with their dynamic_cast) to the direct dispatch
+    table used by the loader's command handlers, which check the form type code instead.
+*/
+#include "TestHarness.h"
+#include "Submodule/Interface.h"
+
+// local declaration of submodule interface defined in the test harness
+extern SubmoduleInterface* g_submoduleInfc;
+extern const SubmoduleCommandTable* g_submoduleCmds;
+
+static const UInt32 kFormCount = 0x400;
+
+int main(int argc, char* argv[])
+{
+    Test_Initialize();
+    UInt32 count = Test_Count(argc,argv,2000000);
+    std::vector<TESForm*> forms(kFormCount);
+    for (UInt32 i = 0; i < kFormCount; i++) forms[i] = Test_CreateMyForm(0x01000800 + i);
+
+    // virtual interface
+    UInt64 sum = 0;
+    UInt64 start = PerfTicks();
+    for (UInt32 i = 0; i < count; i++) g_submoduleInfc->SetMyFormExtraData(forms[i % kFormCount],i);
+    UInt64 setTicks = PerfTicks() - start;
+    start = PerfTicks();
+    for (UInt32 i = 0; i < count; i++) sum += g_submoduleInfc->GetMyFormExtraData(forms[i % kFormCount]);
+    UInt64 getTicks = PerfTicks() - start;
+    g_submoduleInfc->CommitMyFormWrites();
+
+    // direct dispatch, with the type check performed by the loader
+    UInt64 directSum = 0;
+    start = PerfTicks();
+    for (UInt32 i = 0; i < count; i++)
+    {
+        TESForm* form = forms[i % kFormCount];
+        if (form->GetFormType() == g_submoduleCmds->myFormType) g_submoduleCmds->SetMyFormExtraData(form,i);
+    }
+    UInt64 directSetTicks = PerfTicks() - start;
+    start = PerfTicks();
+    for (UInt32 i = 0; i < count; i++)
+    {
+        TESForm* form = forms[i % kFormCount];
+        if (form->GetFormType() == g_submoduleCmds->myFormType) directSum += g_submoduleCmds->GetMyFormExtraData(form);
+    }
+    UInt64 directGetTicks = PerfTicks() - start;
+    g_submoduleInfc->CommitMyFormWrites();
+
+    // both paths see the same writes
+    CHECK(sum == directSum);
+    CHECK(g_submoduleCmds->GetMyFormExtraData(forms[0]) == (count - 1) / kFormCount * kFormCount);  // last write to the first form
+
+    Test_Bench("SetMyFormExtraData, virtual",count,"call",setTicks);
+    Test_Bench("GetMyFormExtraData, virtual",count,"call",getTicks);
+    Test_Bench("SetMyFormExtraData, direct",count,"call",directSetTicks);
+    Test_Bench("GetMyFormExtraData, direct",count,"call",directGetTicks);
+    Test_DestroyMyForms();
+    return Test_Result("DispatchBench");
+}
@@ -0,0 +1,116 @@
+/*
+    EditorID index: hash collisions, duplicate EditorIDs & lookup throughput
+    Distinct EditorIDs with the same 32-bit hash must all be found (they can never be separated by a
+    perfect hash seed), and removing the newer of two forms with the same EditorID must expose the older
+    one again, whether the newer one is in the table or in the overflow list.  A rename in the CS, made on a
+    temporary working copy, must re-index the listed form.
+*/
+#include "TestHarness.h"
+#include "Submodule/EditorIDIndex.h"
+
+// pairs of distinct EditorIDs with the same case insensitive FNV-1a hash
+static const char* s_collisions[][2] =
+{
+    { "CollisionForm112782", "CollisionForm349199" },
+    { "CollisionForm112783", "CollisionForm349198" },
+    { "CollisionForm112788", "CollisionForm349193" },
+    { "CollisionForm112789", "CollisionForm349192" },
+};
+static const UInt32 kCollisionCount = sizeof(s_collisions) / sizeof(s_collisions[0]);
+
+int main(int argc, char* argv[])
+{
+    Test_Initialize();
+    UInt32 count = Test_Count(argc,argv,100000);
+
+    // the index never dereferences forms, so unloaded forms will do
+    std::vector<MyForm*> forms(count + 2 * kCollisionCount + 4);
+    for (UInt32 i = 0; i < forms.size(); i++) forms[i] = (MyForm*)MyForm::CreateMyForm();
+    MyForm** colliding = &forms[count];
+    MyForm** duplicates = &forms[count + 2 * kCollisionCount];
+
+    // colliding EditorIDs, among many others
+    MyFormEditorIDIndex index;
+    char editorID[0x40];
+    UInt64 start = PerfTicks();
+    for (UInt32 i = 0; i < count; i++)
+    {
+        sprintf_s(editorID,sizeof(editorID),"IndexedForm%06u",i);
+        index.Add(forms[i],editorID);
+    }
+    for (UInt32 c = 0; c < kCollisionCount; c++)
+    {
+        index.Add(colliding[2*c],s_collisions[c][0]);
+        index.Add(colliding[2*c+1],s_collisions[c][1]);
+    }
+    UInt64 addTicks = PerfTicks() - start;
+    start = PerfTicks();
+    CHECK(index.Lookup("IndexedForm000000") == forms[0]);  // builds the table
+    UInt64 buildTicks = PerfTicks() - start;
+    for (UInt32 c = 0; c < kCollisionCount; c++)
+    {
+        CHECK(index.Lookup(s_collisions[c][0]) == colliding[2*c]);
+        CHECK(index.Lookup(s_collisions[c][1]) == colliding[2*c+1]);
+    }
+    CHECK(index.Lookup("collisionFORM112782") == colliding[0]);
+    index.Remove(colliding[0]);
+    CHECK(index.Lookup(s_collisions[0][0]) == 0 && index.Lookup(s_collisions[0][1]) == colliding[1]);
+    index.Add(colliding[0],s_collisions[0][0]);
+
+    // the newer of two duplicates is found, and the older one again once the newer one is removed
+    index.Add(duplicates[0],"DuplicateForm");
+    index.Add(duplicates[1],"duplicateform");
+    CHECK(index.Lookup("DuplicateForm") == duplicates[1]);
+    for (UInt32 i = 0; i < 0x40; i++)
+    {
+        sprintf_s(editorID,sizeof(editorID),"RebuildForm%02u",i);  // enough overflow to force a rebuild
+        index.Add(forms[i],editorID);
+    }
+    CHECK(index.Lookup("RebuildForm00") == forms[0]);
+    CHECK(index.Lookup("IndexedForm000000") == 0);
+    CHECK(index.Lookup("DuplicateForm") == duplicates[1]);
+    index.Remove(duplicates[1]);
+    CHECK(index.Lookup("DuplicateForm") == duplicates[0]);
+
+    // the same for a duplicate in the overflow list, and for a shadowed form that is re-indexed
+    index.Add(duplicates[2],"DuplicateForm");
+    CHECK(index.Lookup("DuplicateForm") == duplicates[2]);
+    index.Remove(duplicates[2]);
+    CHECK(index.Lookup("DuplicateForm") == duplicates[0]);
+    index.Add(duplicates[3],"DuplicateForm");
+    index.Add(duplicates[0],"RenamedForm");
+    CHECK(index.Lookup("RenamedForm") == duplicates[0]);
+    index.Remove(duplicates[3]);
+    CHECK(index.Lookup("DuplicateForm") == 0);
+    CHECK(index.Count() == count + 2 * kCollisionCount + 1);
+
+    // lookups
+    UInt32 found = 0;
+    start = PerfTicks();
+    for (UInt32 i = 0; i < count; i++)
+    {
+        sprintf_s(editorID,sizeof(editorID),"IndexedForm%06u",(i * 0x9E3779B1) % count);
+        if (index.Lookup(editorID)) found++;
+    }
+    UInt64 lookupTicks = PerfTicks() - start;
+    CHECK(found == count - 0x40);
+
+    // a CS dialog renames a form through a temporary working copy, which is copied back when committed;
+    // the working copy is never indexed, and the listed form is found under its new EditorID
+    MyForm* listed = Test_CreateMyForm(0x01000800,"DialogForm");
+    MyForm* workingCopy = (MyForm*)MyForm::CreateMyForm();
+    workingCopy->CopyFrom(*listed);
+    workingCopy->SetEditorID("DialogFormRenamed");  // as set from the dialog controls
+    CHECK(g_myFormEditorIDs.Lookup("DialogForm") == listed);
+    listed->CopyFrom(*workingCopy);
+    delete workingCopy;
+    CHECK(g_myFormEditorIDs.Lookup("DialogFormRenamed") == listed);
+    CHECK(g_myFormEditorIDs.Lookup("DialogForm") == 0);
+    Test_DestroyMyForms();
+
+    Test_Bench("Add EditorID",count,"form",addTicks);
+    Test_Bench("Build EditorID table",count,"form",buildTicks);
+    Test_Bench("Lookup EditorID",count,"lookup",lookupTicks);
+    for (UInt32 i = 0; i < forms.size(); i++) delete forms[i];
+    return Test_Result("EditorIDIndexTest");
+}
@@ -0,0 +1,87 @@
+/*
+    Flight recorder: dumps on error, from any thread
+    An error dumps the lines recorded before it to the log file, once and without repeating the error line,
+    which the log file target has already written.  The log file is only ever written on the main thread:
+    an error on another thread captures its context at once, and the main thread writes it at the next
+    line it logs.  Recording throughput is reported.
+*/
+#include "TestHarness.h"
+#include "Loader/targets.h"
+
+#include <string>
+
+// local declaration of log file target defined in the test harness
+extern OutputTarget* _gLogFile;
+
+// stand-in log file, holding the lines written to it & whether all of them were written on the main thread
+class LogFileTarget : public OutputTarget
+{
+public:
+    virtual void WriteOutputLine(const OutputStyle& style, time_t time, int channel, const char* source, const char* text)
+    {
+        lines.push_back(text);
+        if (GetCurrentThreadId() != mainThreadID) offMainThread++;
+    }
+    UInt32 Find(const char* text) const
+    {
+        UInt32 found = 0;
+        for (UInt32 i = 0; i < lines.size(); i++) found += lines[i] == text;
+        return found;
+    }
+    std::vector<std::string>    lines;
+    DWORD                       mainThreadID;
+    UInt32                      offMainThread;
+    LogFileTarget() : mainThreadID(GetCurrentThreadId()), offMainThread(0) {}
+};
+
+static DWORD WINAPI WorkerThread(LPVOID param)
+{
+    _VMESSAGE("worker context");
+    _ERROR("worker error");
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    UInt32 count = Test_Count(argc,argv,200000);
+    LogFileTarget file;
+    _gLogFile = &file;
+    _FlightRecorderTarget.Enable(8);
+    gLog.AttachTarget(_FlightRecorderTarget);   // the log file target is not attached, so it only receives dumps
+
+    // an error dumps the preceding lines, but not the error itself
+    _VMESSAGE("context 1");
+    _DMESSAGE("context 2");
+    _ERROR("main error");
+    CHECK(file.lines.size() == 4);  // header, 2 lines, footer
+    CHECK(file.Find("context 1") == 1 && file.Find("context 2") == 1);
+    CHECK(file.Find("main error") == 0);
+    _ERROR("main error");   // nothing recorded since the last dump
+    CHECK(file.lines.size() == 4);
+
+    // an error on another thread is written by the main thread, at its next line
+    HANDLE thread = CreateThread(NULL,0,&WorkerThread,0,0,NULL);
+    CHECK(thread != 0);
+    WaitForSingleObject(thread,INFINITE);
+    CloseHandle(thread);
+    CHECK(file.lines.size() == 4);
+    _VMESSAGE("main context");
+    CHECK(file.lines.size() == 7 && file.Find("worker context") == 1 && file.Find("worker error") == 0);
+    CHECK(file.Find("main context") == 0);  // recorded after the capture, for the next dump
+    _FlightRecorderTarget.Dump();
+    CHECK(file.Find("main context") == 1);
+    CHECK(file.offMainThread == 0);
+
+    // recording throughput; the ring wraps, and only the last lines are dumped
+    file.lines.clear();
+    UInt64 start = PerfTicks();
+    for (UInt32 i = 0; i < count; i++) _VMESSAGE("MyForm %08X: name='Example Form %u', weight=%f, value=%i",0x01000800 + i,i,1.5,i);
+    UInt64 ticks = PerfTicks() - start;
+    _FlightRecorderTarget.Dump();
+    CHECK(file.lines.size() == 8 + 2);
+    gLog.DetachTarget(_FlightRecorderTarget);
+    _gLogFile = 0;
+
+    Test_Bench("record line in flight recorder",count,"line",ticks);
+    return Test_Result("FlightRecorderTest");
+}
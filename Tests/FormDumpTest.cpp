@@ -0,0 +1,67 @@
+/*
+    MyForm dump: escaping & capture throughput
+    The JSON dump must be valid UTF-8 JSON whatever bytes EditorIDs & names contain: quotes, backslashes,
+    control characters and bytes above 0x7F (the game's codepage, cp1252) are all escaped, with the
+    cp1252-only characters in 0x80-0x9F mapped to their unicode code points.  The CSV
+    dump doubles quotes, and leaves other bytes as they are.
+*/
+#include "TestHarness.h"
+#include "Submodule/FormDump.h"
+
+#include <string>
+
+// reads the dump written to the path used by MyFormDump
+static std::string ReadDump(const char* extension)
+{
+    std::string path = "Data\\obse\\plugins\\" SOLUTIONNAME "\\MyForms.";
+    path += extension;
+    std::string contents;
+    FILE* file = 0;
+    if (fopen_s(&file,path.c_str(),"rb") != 0 || !file) return contents;
+    char buffer[0x1000];
+    for (size_t read; (read = fread(buffer,1,sizeof(buffer),file)) > 0;) contents.append(buffer,read);
+    fclose(file);
+    remove(path.c_str());
+    return contents;
+}
+static MyFormDump::Status WaitForDump()
+{
+    MyFormDump::Status status;
+    while ((status = g_myFormDump.GetStatus()) == MyFormDump::kStatus_Running) Sleep(1);
+    return status;
+}
+
+int main(int argc, char* argv[])
+{
+    Test_Initialize();
+    UInt32 count = Test_Count(argc,argv,10000);
+
+    MyForm* special = Test_CreateMyForm(0x01000800,"Caf\xE9" "Form");
+    special->name.Set("Quote \" Backslash \\ Tab \t Umlaut \xFC");
+    MyForm* smart = Test_CreateMyForm(0x01000801);
+    smart->name.Set("\x93Smart\x94 \x80 \x81");
+    for (UInt32 i = 2; i < count; i++) Test_CreateMyForm(0x01000800 + i);
+
+    // JSON
+    UInt64 start = PerfTicks();
+    CHECK(g_myFormDump.Start(true));
+    UInt64 captureTicks = PerfTicks() - start;
+    CHECK(WaitForDump() == MyFormDump::kStatus_Done);
+    std::string json = ReadDump("json");
+    CHECK(json.find("\"editorID\":\"Caf\\u00e9Form\"") != std::string::npos);
+    CHECK(json.find("\"name\":\"Quote \\\" Backslash \\\\ Tab \\u0009 Umlaut \\u00fc\"") != std::string::npos);
+    CHECK(json.find("\"name\":\"\\u201cSmart\\u201d \\u20ac \\u0081\"") != std::string::npos);
+    bool ascii = !json.empty();
+    for (UInt32 i = 0; i < json.size(); i++) ascii = ascii && (UInt8)json[i] < 0x80;
+    CHECK(ascii);
+
+    // CSV
+    CHECK(g_myFormDump.Start(false));
+    CHECK(WaitForDump() == MyFormDump::kStatus_Done);
+    std::string csv = ReadDump("csv");
+    CHECK(csv.find("\"Caf\xE9" "Form\",\"Quote \"\" Backslash \\ Tab \t Umlaut \xFC\"") != std::string::npos);
+
+    Test_Bench("Capture MyForms for dump",count,"form",captureTicks);
+    Test_DestroyMyForms();
+    return Test_Result("FormDumpTest");
+}
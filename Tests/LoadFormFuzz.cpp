@@ -0,0 +1,111 @@
+/*
+    MyForm record parsing: fuzzing entry point & corpus runner
+    LLVMFuzzerTestOneInput() loads one record (header & body) through the stand-in TESFile into a new MyForm.
+    Built with LOAD_FORM_FUZZER (the LoadFormFuzzer target, clang only) it is driven by libFuzzer; otherwise
+    this is the LoadFormCorpus runner, which replays every file in the corpus directories or files given on
+    the command line, along with all truncations and a fixed set of byte mutations of each.  A crash, a
+    sanitizer report or a failed check is a parsing bug; crash artifacts from libFuzzer can be replayed
+    with the runner.
+*/
+#include "TestHarness.h"
+#include "API/TESFiles/TESFile.h"
+
+#include <dirent.h>
+
+// load warnings are expected for malformed records, and are discarded rather than sent to stderr
+static BufferTarget s_loadWarnings;
+
+extern "C" int LLVMFuzzerTestOneInput(const UInt8* data, size_t size)
+{
+    static bool initialized = false;
+    if (!initialized)
+    {
+        Test_Initialize();
+        gLog.AttachTarget(s_loadWarnings);
+        initialized = true;
+    }
+    MyForm* myform = (MyForm*)MyForm::CreateMyForm();
+    TESFile file("Fuzz.esp",data,size);
+    myform->LoadForm(file);
+    const char* editorID = myform->GetEditorID();
+    if (!CHECK(editorID && strlen(editorID) < 0x200)) abort();  // EDID chunks are truncated to the load buffer
+    delete myform;
+    return 0;
+}
+
+#ifndef LOAD_FORM_FUZZER
+static UInt32 s_inputs = 0;
+
+static void RunInput(const std::vector<UInt8>& input)
+{
+    LLVMFuzzerTestOneInput(input.empty() ? 0 : &input[0],input.size());
+    s_inputs++;
+}
+static void RunSeed(const std::vector<UInt8>& seed)
+{
+    // the seed, every truncation of it, and byte mutations from a fixed generator
+    RunInput(seed);
+    for (UInt32 length = 0; length < seed.size(); length++) RunInput(std::vector<UInt8>(seed.begin(),seed.begin() + length));
+    UInt32 random = 0x12345678;
+    std::vector<UInt8> mutated;
+    for (UInt32 m = 0; m < 256 && !seed.empty(); m++)
+    {
+        mutated = seed;
+        for (UInt32 n = 0; n <= m % 4; n++)
+        {
+            random = random * 1664525 + 1013904223;
+            UInt32 offset = (random >> 8) % mutated.size();
+            mutated[offset] = (m & 1) ? (UInt8)(random >> 24) : mutated[offset] ^ (1 << (random & 7));
+        }
+        RunInput(mutated);
+    }
+}
+static bool RunFile(const char* path)
+{
+    FILE* file = 0;
+    if (fopen_s(&file,path,"rb") != 0 || !file) return false;
+    std::vector<UInt8> seed;
+    UInt8 buffer[0x1000];
+    for (size_t read; (read = fread(buffer,1,sizeof(buffer),file)) > 0;) seed.insert(seed.end(),buffer,buffer + read);
+    fclose(file);
+    RunSeed(seed);
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    Test_Initialize();
+    UInt64 start = PerfTicks();
+
+    // records built by the harness, with & without an EditorID
+    RunSeed(Test_MyFormRecord(0x01000800));
+    RunSeed(Test_MyFormRecord(0x01000801,"CorpusForm",42));
+
+    // corpus directories & crash artifacts
+    UInt32 files = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        DIR* directory = opendir(argv[i]);
+        if (!directory)
+        {
+            CHECK(RunFile(argv[i]));
+            files++;
+            continue;
+        }
+        char path[MAX_PATH];
+        for (dirent* entry = readdir(directory); entry; entry = readdir(directory))
+        {
+            if (entry->d_name[0] == '.') continue;
+            sprintf_s(path,sizeof(path),"%s/%s",argv[i],entry->d_name);
+            CHECK(RunFile(path));
+            files++;
+        }
+        closedir(directory);
+    }
+    CHECK(argc < 2 || files > 0);
+
+    printf("%u corpus files\n",files);
+    Test_Bench("Load fuzzed records",s_inputs,"record",PerfTicks() - start);
+    return Test_Result("LoadFormCorpus");
+}
+#endif
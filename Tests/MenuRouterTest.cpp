@@ -0,0 +1,72 @@
+/*
+    Menu command router
+    Placement of the reserved range by form type, identifier allocation over it, exhaustion, rejection of
+    identifiers outside the range,
+    and the dispatch cost with one route and with the full table (reported, not checked).
+*/
+#include "TestHarness.h"
+#include "Submodule/MenuRouter.h"
+
+static UInt32 s_calls[MenuRouter::kIdentifierCount];
+
+static void CountCall(void* param)
+{
+    s_calls[(UInt32)(uintptr_t)param]++;
+}
+
+// average dispatch time for identifier, in nanoseconds
+static double DispatchTime(UInt32 identifier, UInt32 count)
+{
+    UInt64 start = PerfTicks();
+    for (UInt32 i = 0; i < count; i++) MenuRouter::Dispatch(identifier);
+    return PerfTicksToUS(PerfTicks() - start) * 1000.0 / count;
+}
+
+int main(int argc, char* argv[])
+{
+    UInt32 count = Test_Count(argc,argv,1000000);
+
+    // nothing is allocated until the range is placed; the first placement wins
+    CHECK(MenuRouter::IdentifierBase() == 0);
+    CHECK(MenuRouter::Allocate(&CountCall,(void*)0) == 0);
+    MenuRouter::PlaceRange(0x25);
+    MenuRouter::PlaceRange(0x26);
+    const UInt32 base = MenuRouter::IdentifierBase();
+    CHECK(base == 0xCC00 + 0x250);
+    MenuRouter::PlaceRange(0xFF);  // the highest form type still fits in a 16-bit command identifier
+    CHECK(MenuRouter::kIdentifierRangeStart + (0xFF << 4) + MenuRouter::kIdentifierCount <= 0x10000);
+
+    // identifiers are allocated sequentially from the base
+    UInt32 first = MenuRouter::Allocate(&CountCall,(void*)0);
+    CHECK(first == base);
+    double singleRoute = DispatchTime(first,count);
+    for (UInt32 i = 1; i < MenuRouter::kIdentifierCount; i++)
+    {
+        CHECK(MenuRouter::Allocate(&CountCall,(void*)(uintptr_t)i) == base + i);
+    }
+
+    // the range is exhausted
+    CHECK(MenuRouter::Allocate(&CountCall,(void*)0) == 0);
+
+    // every identifier reaches its own handler
+    memset(s_calls,0,sizeof(s_calls));
+    for (UInt32 i = 0; i < MenuRouter::kIdentifierCount; i++) CHECK(MenuRouter::Dispatch(base + i));
+    bool each = true;
+    for (UInt32 i = 0; i < MenuRouter::kIdentifierCount; i++) each = each && s_calls[i] == 1;
+    CHECK(each);
+
+    // identifiers outside the range are not routed, including those below the base and in neighbouring ranges
+    CHECK(!MenuRouter::Dispatch(MenuRouter::kIdentifierRangeStart + (0x24 << 4)));
+    CHECK(!MenuRouter::Dispatch(base - 1));
+    CHECK(!MenuRouter::Dispatch(base + MenuRouter::kIdentifierCount));
+    CHECK(!MenuRouter::Dispatch(0));
+    CHECK(!MenuRouter::Dispatch(0xFFFF));
+    CHECK(!MenuRouter::Dispatch(0xFFFFFFFF));
+
+    // dispatch is a table lookup: the last of 16 routes should cost about the same as a single route
+    // timings are reported only; wall-clock comparisons are too noisy on shared machines to assert
+    double fullTable = DispatchTime(base + MenuRouter::kIdentifierCount - 1,count);
+    double unrouted = DispatchTime(0x1000,count);
+    printf("dispatch: %.2f ns with 1 route, %.2f ns with %u routes, %.2f ns unrouted\n",singleRoute,fullTable,MenuRouter::kIdentifierCount,unrouted);
+    return Test_Result("MenuRouterTest");
+}
@@ -0,0 +1,114 @@
+/*
+    FormID index: membership & range query throughput
+    The index holds exactly the forms in the FormList, keyed by their current formIDs.  Range & mod index
+    queries over 100k forms are timed, along with the rebuild after a load, and checked against a scan.
+*/
+#include "TestHarness.h"
+#include "Submodule/FormIndex.h"
+#include "API/TESFiles/TESFile.h"
+
+// number of forms in [first, last], by scanning the form list
+static UInt32 ScanRange(UInt32 first, UInt32 last)
+{
+    UInt32 count = 0;
+    for (BSSimpleList<TESForm*>::Node* node = &MyForm::extendedForm.FormList().firstNode; node && node->data; node = node->next)
+    {
+        if (node->data->formID >= first && node->data->formID <= last) count++;
+    }
+    return count;
+}
+
+int main(int argc, char* argv[])
+{
+    Test_Initialize();
+    UInt32 count = Test_Count(argc,argv,100000);
+    TESForm* const* forms = 0;
+
+    // a form constructed by the CS as a temporary is never added to the form list, so it is not indexed
+    TESForm* temporary = MyForm::CreateMyForm();
+    temporary->formID = 0x01000100;
+    CHECK(g_myFormIndex.FindRange(0,0xFFFFFFFF,forms) == 0);
+
+    // a form indexed before its formID was assigned is found under the assigned formID
+    MyForm* late = (MyForm*)MyForm::CreateMyForm();
+    CHECK(g_myFormIndex.Count() == 0);
+    std::vector<UInt8> record = Test_MyFormRecord(0x02000010);
+    TESFile file("Late.esp",&record[0],record.size());
+    late->LoadForm(file);
+    MyForm::extendedForm.AddToFormList(late);
+    CHECK(g_myFormIndex.FindRange(0x02000010,0x02000010,forms) == 1 && forms[0] == late);
+    CHECK(g_myFormIndex.FindRange(0,0,forms) == 0);
+
+    // load forms spread over 4 mod indices, in a scrambled order
+    UInt64 start = PerfTicks();
+    for (UInt32 i = 0; i < count; i++)
+    {
+        UInt32 n = (i * 0x9E3779B1) % count;
+        Test_CreateMyForm(((n & 3) << 24) | (0x800 + n));
+    }
+    UInt64 loadTicks = PerfTicks() - start;
+    start = PerfTicks();
+    CHECK(g_myFormIndex.Count() == count + 1);
+    UInt64 buildTicks = PerfTicks() - start;
+
+    // results match a scan, and are sorted
+    UInt32 sorted = g_myFormIndex.FindRange(0,0xFFFFFFFF,forms);
+    bool ordered = true;
+    for (UInt32 i = 1; i < sorted; i++) ordered = ordered && forms[i-1]->formID <= forms[i]->formID;
+    CHECK(ordered);
+    for (UInt32 m = 0; m < 4; m++) CHECK(g_myFormIndex.FindModIndex(m,forms) == ScanRange(m << 24,(m << 24) | 0xFFFFFF));
+    CHECK(g_myFormIndex.FindRange(0x01000800,0x01001800,forms) == ScanRange(0x01000800,0x01001800));
+
+    // range queries
+    UInt32 queries = count * 2;
+    UInt64 found = 0;
+    start = PerfTicks();
+    for (UInt32 q = 0; q < queries; q++)
+    {
+        UInt32 first = ((q & 3) << 24) | (0x800 + (q * 0x9E3779B1) % count);
+        found += g_myFormIndex.FindRange(first,first + 0x40,forms);
+    }
+    UInt64 queryTicks = PerfTicks() - start;
+    CHECK(found > 0);
+
+    // forms created one at a time are inserted, without rebuilding the index
+    UInt32 creates = count / 100;
+    UInt32 inserted = 0;
+    start = PerfTicks();
+    for (UInt32 i = 0; i < creates; i++)
+    {
+        UInt32 formID = 0x05000800 + (i * 7919) % creates;   // scrambled order
+        Test_CreateMyForm(formID);
+        inserted += g_myFormIndex.FindRange(formID,formID,forms) == 1 && forms[0]->formID == formID;
+    }
+    UInt64 createTicks = PerfTicks() - start;
+    CHECK(inserted == creates);
+    CHECK(g_myFormIndex.FindModIndex(5,forms) == creates);
+    for (UInt32 i = 1; i < creates; i++) ordered = ordered && forms[i-1]->formID < forms[i]->formID;
+    CHECK(ordered);
+
+    // a formID changed without notice is re-keyed when a query reaches the form
+    g_myFormIndex.FindRange(0x05000800,0x05000800,forms);
+    TESForm* renumbered = forms[0];
+    renumbered->formID = 0x06000800;
+    CHECK(g_myFormIndex.FindRange(0x05000800,0x05000800,forms) == 0);
+    CHECK(g_myFormIndex.FindModIndex(6,forms) == 1 && forms[0] == renumbered);
+    CHECK(g_myFormIndex.Count() == count + 1 + creates);
+
+    // destroying a form removes it from the index
+    sorted = g_myFormIndex.FindRange(0,0xFFFFFFFF,forms);
+    std::vector<TESForm*> listed(forms,forms + sorted);
+    MyForm::extendedForm.ClearFormList();
+    for (UInt32 i = 0; i < sorted; i++) if (listed[i] != late) MyForm::extendedForm.AddToFormList(listed[i]);
+    delete late;
+    CHECK(g_myFormIndex.FindRange(0x02000010,0x02000010,forms) == 0);
+    CHECK(g_myFormIndex.Count() == count + creates);
+
+    Test_Bench("load MyForm records",count,"form",loadTicks);
+    Test_Bench("rebuild formID index",count,"form",buildTicks);
+    Test_Bench("range query, 64 formIDs wide",queries,"query",queryTicks);
+    Test_Bench("create MyForm & query it",creates,"form",createTicks);
+    Test_DestroyMyForms();
+    delete temporary;
+    return Test_Result("RangeQueryBench");
+}
@@ -0,0 +1,122 @@
+/*
+    Snapshot publishing under concurrent readers
+    One writer (the main thread) repeatedly changes every MyForm and publishes, while N reader threads
+    acquire, validate & release snapshots.  Every snapshot a reader sees must be internally consistent
+    (all values written before the same publish), and generations must never go backwards.  Publishing,
+    committing or refreshing with nothing changed must keep the same snapshot & generation.
+*/
+#include "TestHarness.h"
+#include "Submodule/Snapshot.h"
+#include "Submodule/WriteBuffer.h"
+#include "Submodule/BulkInterface.h"
+#include "Submodule/Interface.h"
+
+// local declaration of submodule interface defined in the test harness
+extern SubmoduleInterface g_submoduleIntfc;
+
+static const UInt32 kReaderCount    = 4;
+static const UInt32 kFormCount      = 0x800;
+
+struct ReaderState
+{
+    volatile LONG*  stop;
+    UInt32          acquired;   // snapshots acquired
+    UInt32          errors;     // inconsistent snapshots
+};
+
+static DWORD WINAPI ReaderThread(LPVOID param)
+{
+    ReaderState& state = *(ReaderState*)param;
+    UInt32 lastGeneration = 0;
+    while (!*state.stop)
+    {
+        MyFormSnapshotLock lock;
+        const MyFormSnapshot* snapshot = lock.snapshot;
+        if (!snapshot) continue;
+        state.acquired++;
+        if (snapshot->generation < lastGeneration || snapshot->count != kFormCount) { state.errors++; continue; }
+        lastGeneration = snapshot->generation;
+        // the writer sets every extraData to the generation about to be published, & weight to match
+        for (UInt32 i = 0; i < snapshot->count; i++)
+        {
+            if (snapshot->extraData[i] != snapshot->generation || snapshot->weights[i] != (float)snapshot->generation
+                || snapshot->formIDs[i] == 0) { state.errors++; break; }
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[])
+{
+    Test_Initialize();
+    UInt32 publishCount = Test_Count(argc,argv,500);
+    std::vector<MyForm*> forms(kFormCount);
+    for (UInt32 i = 0; i < kFormCount; i++) forms[i] = Test_CreateMyForm(0x01000800 + i);
+
+    volatile LONG stop = 0;
+    ReaderState states[kReaderCount];
+    HANDLE threads[kReaderCount];
+    for (UInt32 t = 0; t < kReaderCount; t++)
+    {
+        states[t].stop = &stop;
+        states[t].acquired = states[t].errors = 0;
+        threads[t] = CreateThread(NULL,0,&ReaderThread,&states[t],0,NULL);
+        CHECK(threads[t] != 0);
+    }
+
+    // writer - direct writes (the write buffer is disabled), published explicitly
+    UInt64 start = PerfTicks();
+    for (UInt32 p = 0; p < publishCount; p++)
+    {
+        UInt32 generation = g_myFormSnapshots.Generation() + 1;
+        for (UInt32 i = 0; i < kFormCount; i++)
+        {
+            g_extraDataWrites.Write(forms[i],generation);
+            forms[i]->weight = (float)generation;
+        }
+        g_myFormSnapshots.Publish();
+    }
+    UInt64 ticks = PerfTicks() - start;
+    InterlockedExchange(&stop,1);
+    WaitForMultipleObjects(kReaderCount,threads,TRUE,INFINITE);
+
+    UInt32 acquired = 0;
+    for (UInt32 t = 0; t < kReaderCount; t++)
+    {
+        CloseHandle(threads[t]);
+        CHECK(states[t].errors == 0);
+        acquired += states[t].acquired;
+    }
+    CHECK(g_myFormSnapshots.Generation() == publishCount);
+
+    // buffers are recycled: at most one per pinned reader, plus the active & the one being filled
+    UInt32 bufferBytes = sizeof(MyFormSnapshot) + kFormCount * 16;
+    CHECK(g_myFormSnapshots.MemoryUsage() <= (kReaderCount + 2) * bufferBytes);
+
+    // nothing changed: no publish, by any route
+    UInt32 generation = g_myFormSnapshots.Generation();
+    const MyFormBulkInterface* bulk = g_submoduleIntfc.BulkInterface();
+    CHECK(!g_myFormSnapshots.Publish());
+    CHECK(g_submoduleIntfc.CommitMyFormWrites() == 0 && bulk->Refresh() == generation);
+    UInt64 unchangedStart = PerfTicks();
+    for (UInt32 p = 0; p < publishCount; p++) bulk->Refresh();
+    UInt64 unchangedTicks = PerfTicks() - unchangedStart;
+    CHECK(g_myFormSnapshots.Generation() == generation);
+
+    // any change publishes once
+    g_extraDataWrites.Write(forms[0],generation + 1);
+    CHECK(bulk->Refresh() == generation + 1 && bulk->Refresh() == generation + 1);
+    delete forms[kFormCount - 1];
+    MyForm::extendedForm.ClearFormList();
+    for (UInt32 i = 0; i < kFormCount - 1; i++) MyForm::extendedForm.AddToFormList(forms[i]);
+    CHECK(bulk->Refresh() == generation + 2);
+    MyFormBulkView view;
+    CHECK(bulk->AcquireView(&view) && view.count == kFormCount - 1);
+    bulk->ReleaseView(&view);
+
+    Test_Bench("publish, 4 concurrent readers",publishCount,"publish",ticks);
+    Test_Bench("refresh, unchanged",publishCount,"refresh",unchangedTicks);
+    Test_Bench("acquire & validate, 4 readers",acquired,"snapshot",ticks);
+    Test_DestroyMyForms();
+    return Test_Result("SnapshotStressTest");
+}
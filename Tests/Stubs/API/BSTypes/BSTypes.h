@@ -0,0 +1,33 @@
+/*
+    Stand-in for the COEF Bethesda container types used by the plugin: BSStringT and BSSimpleList
+*/
+#pragma once
+
+// heap string, as held by TESFullName, TESTexture, etc.
+class BSStringT
+{
+public:
+    const char*     c_str() const { return data ? data : ""; }
+    UInt16          Size() const { return length; }   // length, excluding the terminating null
+    void            Set(const char* string);
+    BSStringT() : data(0), length(0) {}
+    ~BSStringT() { delete [] data; }
+private:
+    BSStringT(const BSStringT&);
+    BSStringT&      operator=(const BSStringT&);
+    char*           data;   // null if empty
+    UInt16          length;
+};
+
+// singly linked list with an embedded first node; an empty list has a first node with null data
+template <class T> class BSSimpleList
+{
+public:
+    struct Node
+    {
+        T       data;
+        Node*   next;
+    };
+    Node            firstNode;
+    BSSimpleList() { firstNode.data = 0; firstNode.next = 0; }
+};
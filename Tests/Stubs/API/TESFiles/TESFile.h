@@ -0,0 +1,52 @@
+/*
+    Stand-in for the COEF TESFile class
+
+    A stand-in TESFile reads a single record from a byte buffer: a 20-byte record header (type, data
+    size, flags, formID, version control info) followed by chunks, each a 4-byte type and a 2-byte
+    length (or an 'XXXX' chunk holding the 32-bit length of the next chunk).  Compressed records are
+    inflated when the record is opened, as the engine does.  Chunk lengths are taken from the buffer
+    as-is; reads never go past the end of the record.
+
+    It is also the destination of records saved by TESForm::FinalizeFormRecord(), through activeFile.
+*/
+#pragma once
+
+#include <vector>
+
+class   TESForm;
+
+class TESFile
+{
+public:
+    struct ChunkInfo
+    {
+        UInt32      chunkType;      // zero if there is no current chunk
+        UInt32      chunkLength;
+    };
+
+    // members
+    MEMBER char         fileName[MAX_PATH];
+    MEMBER ChunkInfo    currentChunk;
+
+    // record reading
+    bool                InitializeFormFromRecord(TESForm& form);    // reads record header into form & opens first chunk
+    UInt32              GetChunkType() { return currentChunk.chunkType; }
+    bool                GetNextChunk();                             // opens the next chunk, returns false at end of record
+    bool                GetChunkData(void* buffer, UInt32 size);    // copies up to size bytes of the current chunk
+
+    // stand-in only
+    TESFile(const char* name, const void* record = 0, UInt32 size = 0);
+    std::vector<UInt8>  saved;          // records saved while this is the active file
+    static TESFile*     activeFile;
+
+private:
+    bool                OpenChunk(UInt32 offset);
+
+    const UInt8*        record;
+    UInt32              recordSize;
+    std::vector<UInt8>  inflated;       // body of a compressed record
+    const UInt8*        body;
+    UInt32              bodySize;
+    UInt32              chunkOffset;    // offset of current chunk data in body
+    UInt32              nextOffset;     // offset of next chunk header in body
+};
@@ -0,0 +1,62 @@
+/*
+    Stand-in for the COEF BaseFormComponent classes used by MyForm
+    Each component loads & saves its own chunk through the stand-in TESFile & form record buffer.
+*/
+#pragma once
+
+#include "API/BSTypes/BSTypes.h"
+
+class   TESForm;
+class   TESFile;
+
+class BaseFormComponent
+{
+public:
+    virtual         ~BaseFormComponent() {}
+};
+
+class TESFullName : public BaseFormComponent
+{
+public:
+    MEMBER BSStringT    name;
+    void                LoadComponent(TESForm& form, TESFile& file);
+    void                SaveComponent();    // saves a FULL chunk
+};
+
+class TESDescription : public BaseFormComponent
+{
+public:
+    const char*         GetDescription(TESForm* form, UInt32 chunkType);
+    void                SetDescription(const char* text);   // stand-in only
+    void                LoadComponent(TESForm& form, TESFile& file);
+    void                SaveComponent();    // saves a DESC chunk
+private:
+    BSStringT           description;
+};
+
+class TESTexture : public BaseFormComponent
+{
+public:
+    MEMBER BSStringT    texturePath;
+};
+
+class TESIcon : public TESTexture
+{
+public:
+    void                LoadComponent(TESForm& form, TESFile& file);
+    void                SaveComponent(UInt32 chunkType);
+};
+
+class TESValueForm : public BaseFormComponent
+{
+public:
+    MEMBER SInt32       goldValue;
+    TESValueForm() : goldValue(0) {}
+};
+
+class TESWeightForm : public BaseFormComponent
+{
+public:
+    MEMBER float        weight;
+    TESWeightForm() : weight(0) {}
+};
@@ -0,0 +1,49 @@
+/*
+    Stand-in for the COEF TESForm & TESFormIDListView classes
+
+    Only the members & methods used by the plugin are declared.  The generic component & form record
+    methods operate on the stand-in components declared in BaseFormComponent.h; saved records are
+    appended to the stand-in TESFile::activeFile.
+*/
+#pragma once
+
+#include "API/TESForms/BaseFormComponent.h"
+
+class TESForm : public BaseFormComponent
+{
+public:
+    // members
+    MEMBER UInt8        formType;
+    MEMBER UInt8        pad01[3];
+    MEMBER UInt32       formFlags;
+    MEMBER UInt32       formID;
+
+    // virtual methods
+    virtual             ~TESForm() {}
+    virtual bool        LoadForm(TESFile& file) { return false; }
+    virtual void        SaveFormChunks() {}
+    virtual UInt8       GetFormType() { return formType; }
+    virtual void        CopyFrom(TESForm& form) {}
+    virtual bool        CompareTo(TESForm& compareTo) { return true; }
+    virtual const char* GetEditorID() { return editorID.c_str(); }
+    virtual bool        SetEditorID(const char* newEditorID) { editorID.Set(newEditorID); return true; }
+
+    // generic components, i.e. TESValueForm & TESWeightForm, in that order, followed by class-specific data
+    bool                LoadGenericComponents(TESFile& file, void* extraData, UInt32 extraDataSize);
+    void                SaveGenericComponents(void* extraData, UInt32 extraDataSize);   // saves a DATA chunk
+    void                CopyAllComponentsFrom(TESForm& form);
+    bool                CompareAllComponentsTo(TESForm& form);
+
+    // form record buffer
+    void                InitializeFormRecord();     // starts a record & saves the EDID chunk
+    void                FinalizeFormRecord();       // appends the record to TESFile::activeFile
+
+    TESForm() : formType(0), formFlags(0), formID(0) { pad01[0] = pad01[1] = pad01[2] = 0; }
+
+private:
+    BSStringT           editorID;
+};
+
+class TESFormIDListView : public TESForm
+{
+};
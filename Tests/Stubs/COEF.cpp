@@ -0,0 +1,301 @@
+/*
+    Stand-in COEF classes, for the Linux test & benchmark build
+    See Prefix.h & the stand-in headers next to this file
+*/
+#include "API/TESForms/TESForm.h"
+#include "API/TESFiles/TESFile.h"
+#include "Components/ExtendedForm.h"
+
+#include <zlib.h>
+
+/*--------------------------------------------------------------------------------------------*/
+// output log
+void OutputLog::Output(int channel, const char* format, ...)
+{
+    if (!targetCount && channel > 2) return;  // discarded without formatting
+    char text[0x400];
+    UInt32 length = (indent * 4 < sizeof(text)) ? indent * 4 : 0;
+    memset(text,' ',length);
+    va_list args;
+    va_start(args,format);
+    vsnprintf(text + length,sizeof(text) - length,format,args);
+    va_end(args);
+    if (!targetCount) { fprintf(stderr,"%s\n",text); return; }
+    time_t now = time(0);
+    for (UInt32 i = 0; i < targetCount; i++) targets[i]->WriteOutputLine(targets[i]->style,now,channel,"",text);
+}
+void OutputLog::AttachTarget(OutputTarget& target)
+{
+    if (targetCount < sizeof(targets)/sizeof(targets[0])) targets[targetCount++] = &target;
+}
+void OutputLog::DetachTarget(OutputTarget& target)
+{
+    for (UInt32 i = 0; i < targetCount; i++) if (targets[i] == &target) { targets[i] = targets[--targetCount]; break; }
+}
+void BufferTarget::WriteOutputLine(const OutputStyle& style, time_t time, int channel, const char* source, const char* text)
+{
+    strncpy_s(line,sizeof(line),text,_TRUNCATE);
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// strings
+void BSStringT::Set(const char* string)
+{
+    delete [] data;
+    data = 0;
+    length = 0;
+    if (!string || !*string) return;
+    length = strlen(string);
+    data = new char[length + 1];
+    memcpy(data,string,length + 1);
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// form record buffer, filled by the 'Save' methods between InitializeFormRecord() & FinalizeFormRecord()
+static std::vector<UInt8>  s_formRecord;
+static const UInt32        kRecordHeaderSize = 20; // type, data size, flags, formID, version control info
+
+static void FormRecord_Put(const void* data, UInt32 size)
+{
+    s_formRecord.insert(s_formRecord.end(),(const UInt8*)data,(const UInt8*)data + size);
+}
+static void FormRecord_PutChunk(UInt32 chunkType, const void* data, UInt32 size)
+{
+    if (size > 0xFFFF)
+    {
+        // oversized chunks are preceded by an 'XXXX' chunk holding their length
+        UInt32 xxxx = Swap32('XXXX');
+        UInt16 xxxxSize = sizeof(size);
+        FormRecord_Put(&xxxx,sizeof(xxxx));
+        FormRecord_Put(&xxxxSize,sizeof(xxxxSize));
+        FormRecord_Put(&size,sizeof(size));
+        FormRecord_Put(&chunkType,sizeof(chunkType));
+        UInt16 zero = 0;
+        FormRecord_Put(&zero,sizeof(zero));
+    }
+    else
+    {
+        UInt16 shortSize = size;
+        FormRecord_Put(&chunkType,sizeof(chunkType));
+        FormRecord_Put(&shortSize,sizeof(shortSize));
+    }
+    FormRecord_Put(data,size);
+}
+static void FormRecord_PutString(UInt32 chunkType, const BSStringT& string)
+{
+    // strings are saved with their terminating null, and empty strings are not saved at all
+    if (string.Size()) FormRecord_PutChunk(chunkType,string.c_str(),string.Size() + 1);
+}
+static void FormRecord_GetString(TESFile& file, BSStringT& string)
+{
+    char buffer[0x10000];
+    UInt32 length = (file.currentChunk.chunkLength < sizeof(buffer)) ? file.currentChunk.chunkLength : sizeof(buffer) - 1;
+    file.GetChunkData(buffer,length);
+    buffer[length] = 0;
+    string.Set(buffer);
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// components
+void TESFullName::LoadComponent(TESForm& form, TESFile& file) { FormRecord_GetString(file,name); }
+void TESFullName::SaveComponent() { FormRecord_PutString(Swap32('FULL'),name); }
+const char* TESDescription::GetDescription(TESForm* form, UInt32 chunkType) { return description.c_str(); }
+void TESDescription::SetDescription(const char* text) { description.Set(text); }
+void TESDescription::LoadComponent(TESForm& form, TESFile& file) { FormRecord_GetString(file,description); }
+void TESDescription::SaveComponent() { FormRecord_PutString(Swap32('DESC'),description); }
+void TESIcon::LoadComponent(TESForm& form, TESFile& file) { FormRecord_GetString(file,texturePath); }
+void TESIcon::SaveComponent(UInt32 chunkType) { FormRecord_PutString(chunkType,texturePath); }
+
+/*--------------------------------------------------------------------------------------------*/
+// TESForm
+bool TESForm::LoadGenericComponents(TESFile& file, void* extraData, UInt32 extraDataSize)
+{
+    UInt8 buffer[0x100] = {0};
+    UInt32 size = sizeof(SInt32) + sizeof(float) + extraDataSize;
+    if (size > sizeof(buffer)) return false;
+    file.GetChunkData(buffer,size); // a short chunk leaves the remaining fields unchanged
+    UInt32 length = (file.currentChunk.chunkLength < size) ? file.currentChunk.chunkLength : size;
+    TESValueForm* value = dynamic_cast<TESValueForm*>(this);
+    TESWeightForm* weight = dynamic_cast<TESWeightForm*>(this);
+    if (value && length >= 4) memcpy(&value->goldValue,buffer,4);
+    if (weight && length >= 8) memcpy(&weight->weight,buffer + 4,4);
+    if (length > 8) memcpy(extraData,buffer + 8,length - 8);
+    return true;
+}
+void TESForm::SaveGenericComponents(void* extraData, UInt32 extraDataSize)
+{
+    UInt8 buffer[0x100] = {0};
+    TESValueForm* value = dynamic_cast<TESValueForm*>(this);
+    TESWeightForm* weight = dynamic_cast<TESWeightForm*>(this);
+    if (value) memcpy(buffer,&value->goldValue,4);
+    if (weight) memcpy(buffer + 4,&weight->weight,4);
+    memcpy(buffer + 8,extraData,extraDataSize);
+    FormRecord_PutChunk(Swap32('DATA'),buffer,8 + extraDataSize);
+}
+void TESForm::CopyAllComponentsFrom(TESForm& form)
+{
+    if (TESFullName* target = dynamic_cast<TESFullName*>(this))
+        if (TESFullName* source = dynamic_cast<TESFullName*>(&form)) target->name.Set(source->name.c_str());
+    if (TESDescription* target = dynamic_cast<TESDescription*>(this))
+        if (TESDescription* source = dynamic_cast<TESDescription*>(&form)) target->SetDescription(source->GetDescription(&form,0));
+    if (TESIcon* target = dynamic_cast<TESIcon*>(this))
+        if (TESIcon* source = dynamic_cast<TESIcon*>(&form)) target->texturePath.Set(source->texturePath.c_str());
+    if (TESValueForm* target = dynamic_cast<TESValueForm*>(this))
+        if (TESValueForm* source = dynamic_cast<TESValueForm*>(&form)) target->goldValue = source->goldValue;
+    if (TESWeightForm* target = dynamic_cast<TESWeightForm*>(this))
+        if (TESWeightForm* source = dynamic_cast<TESWeightForm*>(&form)) target->weight = source->weight;
+}
+bool TESForm::CompareAllComponentsTo(TESForm& form)
+{
+    // returns true if any component differs
+    if (TESFullName* target = dynamic_cast<TESFullName*>(this))
+        if (TESFullName* source = dynamic_cast<TESFullName*>(&form))
+            if (strcmp(target->name.c_str(),source->name.c_str())) return true;
+    if (TESDescription* target = dynamic_cast<TESDescription*>(this))
+        if (TESDescription* source = dynamic_cast<TESDescription*>(&form))
+            if (strcmp(target->GetDescription(this,0),source->GetDescription(&form,0))) return true;
+    if (TESIcon* target = dynamic_cast<TESIcon*>(this))
+        if (TESIcon* source = dynamic_cast<TESIcon*>(&form))
+            if (strcmp(target->texturePath.c_str(),source->texturePath.c_str())) return true;
+    if (TESValueForm* target = dynamic_cast<TESValueForm*>(this))
+        if (TESValueForm* source = dynamic_cast<TESValueForm*>(&form))
+            if (target->goldValue != source->goldValue) return true;
+    if (TESWeightForm* target = dynamic_cast<TESWeightForm*>(this))
+        if (TESWeightForm* source = dynamic_cast<TESWeightForm*>(&form))
+            if (target->weight != source->weight) return true;
+    return false;
+}
+void TESForm::InitializeFormRecord()
+{
+    // header is completed by FinalizeFormRecord()
+    s_formRecord.assign(kRecordHeaderSize,0);
+    UInt32 type = ExtendedForm::RecordType(GetFormType());
+    memcpy(&s_formRecord[0],&type,4);
+    memcpy(&s_formRecord[8],&formFlags,4);
+    memcpy(&s_formRecord[12],&formID,4);
+    FormRecord_PutString(Swap32('EDID'),editorID);
+}
+void TESForm::FinalizeFormRecord()
+{
+    UInt32 dataSize = s_formRecord.size() - kRecordHeaderSize;
+    memcpy(&s_formRecord[4],&dataSize,4);
+    if (TESFile::activeFile) TESFile::activeFile->saved.insert(TESFile::activeFile->saved.end(),s_formRecord.begin(),s_formRecord.end());
+    s_formRecord.clear();
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// TESFile
+TESFile* TESFile::activeFile = 0;
+
+TESFile::TESFile(const char* name, const void* record, UInt32 size)
+: record((const UInt8*)record), recordSize(size), body(0), bodySize(0), chunkOffset(0), nextOffset(0)
+{
+    strncpy_s(fileName,sizeof(fileName),name,_TRUNCATE);
+    currentChunk.chunkType = 0;
+    currentChunk.chunkLength = 0;
+}
+bool TESFile::InitializeFormFromRecord(TESForm& form)
+{
+    currentChunk.chunkType = 0;
+    currentChunk.chunkLength = 0;
+    if (!record || recordSize < kRecordHeaderSize) return false;
+    UInt32 dataSize;
+    memcpy(&dataSize,record + 4,4);
+    memcpy(&form.formFlags,record + 8,4);
+    memcpy(&form.formID,record + 12,4);
+    body = record + kRecordHeaderSize;
+    bodySize = (dataSize < recordSize - kRecordHeaderSize) ? dataSize : recordSize - kRecordHeaderSize;
+    if (form.formFlags & 0x00040000)
+    {
+        // compressed record: raw body size, then zlib stream; a malformed stream leaves an empty body
+        UInt32 rawSize = 0;
+        if (bodySize >= 4) memcpy(&rawSize,body,4);
+        if (rawSize > 0x1000000) rawSize = 0;   // no record is this large
+        uLongf inflatedSize = rawSize;
+        inflated.resize(rawSize + 1);
+        if (bodySize < 4 || uncompress(&inflated[0],&inflatedSize,body + 4,bodySize - 4) != Z_OK) inflatedSize = 0;
+        body = &inflated[0];
+        bodySize = inflatedSize;
+    }
+    return OpenChunk(0);
+}
+bool TESFile::OpenChunk(UInt32 offset)
+{
+    // reads the chunk header at offset; a truncated header ends the record
+    currentChunk.chunkType = 0;
+    currentChunk.chunkLength = 0;
+    UInt32 length = 0;
+    if (offset <= bodySize && bodySize - offset >= 6 && !memcmp(body + offset,"XXXX",4))
+    {
+        // the length of the next chunk is held in the 'XXXX' chunk data
+        UInt16 size;
+        memcpy(&size,body + offset + 4,2);
+        if (size < 4 || bodySize - offset - 6 < size) return false;
+        memcpy(&length,body + offset + 6,4);
+        offset += 6 + size;
+    }
+    if (offset > bodySize || bodySize - offset < 6) return false;
+    UInt16 size;
+    memcpy(&currentChunk.chunkType,body + offset,4);
+    memcpy(&size,body + offset + 4,2);
+    if (!length) length = size;
+    chunkOffset = offset + 6;
+    nextOffset = (bodySize - chunkOffset > length) ? chunkOffset + length : bodySize;
+    currentChunk.chunkLength = length;  // as recorded, even if the record is truncated
+    return true;
+}
+bool TESFile::GetNextChunk()
+{
+    return currentChunk.chunkType && OpenChunk(nextOffset);
+}
+bool TESFile::GetChunkData(void* buffer, UInt32 size)
+{
+    if (!currentChunk.chunkType) return false;
+    UInt32 available = nextOffset - chunkOffset;
+    if (size > currentChunk.chunkLength) size = currentChunk.chunkLength;
+    if (size > available) size = available;
+    memcpy(buffer,body + chunkOffset,size);
+    return true;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// ExtendedForm
+static ExtendedForm*    s_extendedForms[0x10];
+static UInt32           s_extendedFormCount = 0;
+
+ExtendedForm::ExtendedForm(const char* pluginName, const char* className, const char* description, CreateFunc create)
+: pluginName(pluginName), className(className), description(description), create(create), formType(0)
+{
+    shortName[0] = 0;
+}
+void ExtendedForm::Register(const char* shortName)
+{
+    if (formType) return;
+    strncpy_s(this->shortName,sizeof(this->shortName),shortName,_TRUNCATE);
+    formType = 0x50 + s_extendedFormCount;  // past the vanilla form types
+    s_extendedForms[s_extendedFormCount++] = this;
+}
+UInt32 ExtendedForm::RecordType(UInt8 formType)
+{
+    UInt32 type;
+    memcpy(&type,"NONE",4);
+    for (UInt32 i = 0; i < s_extendedFormCount; i++) if (s_extendedForms[i]->formType == formType) memcpy(&type,s_extendedForms[i]->shortName,4);
+    return type;
+}
+void ExtendedForm::AddToFormList(TESForm* form)
+{
+    if (!formList.firstNode.data) { formList.firstNode.data = form; return; }
+    BSSimpleList<TESForm*>::Node* node = new BSSimpleList<TESForm*>::Node;
+    node->data = form;
+    node->next = formList.firstNode.next;
+    formList.firstNode.next = node;
+}
+void ExtendedForm::ClearFormList()
+{
+    while (BSSimpleList<TESForm*>::Node* node = formList.firstNode.next)
+    {
+        formList.firstNode.next = node->next;
+        delete node;
+    }
+    formList.firstNode.data = 0;
+}
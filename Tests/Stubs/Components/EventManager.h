@@ -0,0 +1,4 @@
+/*
+    Stand-in for Components/EventManager.h, which declares nothing used by the game configuration
+*/
+#pragma once
@@ -0,0 +1,41 @@
+/*
+    Stand-in for the COEF ExtendedForm component
+
+    Registration assigns a fixed form type code.  The form list is maintained by the engine in the game
+    & CS; here, tests add and remove forms explicitly.
+*/
+#pragma once
+
+#include "API/BSTypes/BSTypes.h"
+
+class   TESForm;
+
+class ExtendedForm
+{
+public:
+    typedef TESForm* (*CreateFunc)();
+
+    // members
+    const char*             pluginName;
+    const char*             className;
+    const char*             description;
+    CreateFunc              create;
+
+    // methods
+    void                    Register(const char* shortName);
+    UInt8                   FormType() { return formType; }
+    const char*             ShortName() { return shortName; }
+    BSSimpleList<TESForm*>& FormList() { return formList; }
+
+    // stand-in only, the engine adds forms to the list as they are added to the data handler
+    void                    AddToFormList(TESForm* form);
+    void                    ClearFormList();
+    static UInt32           RecordType(UInt8 formType); // record type saved for forms of a registered type, 'NONE' otherwise
+
+    ExtendedForm(const char* pluginName, const char* className, const char* description, CreateFunc create);
+
+private:
+    UInt8                   formType;
+    char                    shortName[5];
+    BSSimpleList<TESForm*>  formList;
+};
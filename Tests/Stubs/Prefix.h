@@ -0,0 +1,224 @@
+/*
+    Stand-in for the COEF forced-include header, for the Linux test & benchmark build
+
+    The plugin itself only builds with Visual Studio against COEF and OBSE.  The tests build the
+    portable parts of the loader and submodule with gcc or clang instead, against this header and
+    the stand-in COEF/OBSE headers next to it.  It provides the fixed-width types, the subset of the
+    Win32 API & MSVC CRT used by those units, and the COEF output log macros.
+
+    Everything here mirrors the Win32 semantics the plugin relies on (e.g. recursive critical sections,
+    full-barrier interlocked operations, a 32-bit LONG), not the full API.
+*/
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <errno.h>
+#include <time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <unordered_set>
+#include <unordered_map>
+
+// VS2008 provides the TR1 containers in std::tr1
+namespace std { namespace tr1 { using std::unordered_set; using std::unordered_map; } }
+
+/*--------------------------------------------------------------------------------------------*/
+// fixed-width types
+typedef uint8_t     UInt8;
+typedef uint16_t    UInt16;
+typedef uint32_t    UInt32;
+typedef uint64_t    UInt64;
+typedef int8_t      SInt8;
+typedef int16_t     SInt16;
+typedef int32_t     SInt32;
+typedef int64_t     SInt64;
+
+// plugin name, set from the solution name by the Visual Studio projects
+#ifndef SOLUTIONNAME
+#define SOLUTIONNAME "COEF_AdvancedExample"
+#endif
+
+// COEF class declaration markers
+#define MEMBER
+#define _LOCAL
+#define _NOUSE
+
+// byte order swap, used to compare multi-character constants with chunk types read from files
+inline UInt32 Swap32(UInt32 value) { return __builtin_bswap32(value); }
+
+/*--------------------------------------------------------------------------------------------*/
+// Win32 types
+typedef int32_t     LONG;
+typedef uint32_t    DWORD;
+typedef int         BOOL;
+typedef unsigned int UINT;
+typedef void*       HANDLE;
+typedef void*       HMODULE;
+typedef void*       HWND;
+typedef void*       PVOID;
+typedef void*       LPVOID;
+typedef uintptr_t   UINT_PTR;
+typedef uintptr_t   WPARAM;
+typedef intptr_t    LPARAM;
+typedef intptr_t    LRESULT;
+typedef union { struct { DWORD LowPart; LONG HighPart; } u; SInt64 QuadPart; } LARGE_INTEGER;
+struct SYSTEM_INFO { DWORD dwNumberOfProcessors; };
+typedef void (*TIMERPROC)(HWND, UINT, UINT_PTR, DWORD);
+typedef DWORD (*LPTHREAD_START_ROUTINE)(LPVOID);
+
+#define WINAPI
+#define CALLBACK
+#define TRUE        1
+#define FALSE       0
+#define MAX_PATH    260
+#define INFINITE    0xFFFFFFFF
+#define LOWORD(l)   ((UInt16)((l) & 0xFFFF))
+#define PAGE_EXECUTE_READWRITE  0x40
+#define MOVEFILE_REPLACE_EXISTING 0x1
+#define _declspec(x)
+
+/*--------------------------------------------------------------------------------------------*/
+// performance counter, in nanoseconds
+inline BOOL QueryPerformanceCounter(LARGE_INTEGER* ticks)
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC,&now);
+    ticks->QuadPart = (SInt64)now.tv_sec * 1000000000 + now.tv_nsec;
+    return TRUE;
+}
+inline BOOL QueryPerformanceFrequency(LARGE_INTEGER* frequency) { frequency->QuadPart = 1000000000; return TRUE; }
+
+/*--------------------------------------------------------------------------------------------*/
+// interlocked operations, all full barriers like their Win32 counterparts
+inline LONG InterlockedIncrement(volatile LONG* value) { return __atomic_add_fetch(value,1,__ATOMIC_SEQ_CST); }
+inline LONG InterlockedDecrement(volatile LONG* value) { return __atomic_sub_fetch(value,1,__ATOMIC_SEQ_CST); }
+inline LONG InterlockedExchange(volatile LONG* target, LONG value) { return __atomic_exchange_n(target,value,__ATOMIC_SEQ_CST); }
+inline LONG InterlockedCompareExchange(volatile LONG* target, LONG value, LONG comparand)
+{
+    __atomic_compare_exchange_n(target,&comparand,value,false,__ATOMIC_SEQ_CST,__ATOMIC_SEQ_CST);
+    return comparand;
+}
+inline PVOID InterlockedExchangePointer(PVOID volatile* target, PVOID value) { return __atomic_exchange_n(target,value,__ATOMIC_SEQ_CST); }
+#define _ReadWriteBarrier() __asm__ __volatile__("" ::: "memory")
+
+/*--------------------------------------------------------------------------------------------*/
+// critical sections, which are recursive on Windows
+typedef pthread_mutex_t CRITICAL_SECTION;
+inline void InitializeCriticalSection(CRITICAL_SECTION* lock)
+{
+    pthread_mutexattr_t attr;
+    pthread_mutexattr_init(&attr);
+    pthread_mutexattr_settype(&attr,PTHREAD_MUTEX_RECURSIVE);
+    pthread_mutex_init(lock,&attr);
+    pthread_mutexattr_destroy(&attr);
+}
+inline void DeleteCriticalSection(CRITICAL_SECTION* lock) { pthread_mutex_destroy(lock); }
+inline void EnterCriticalSection(CRITICAL_SECTION* lock) { pthread_mutex_lock(lock); }
+inline void LeaveCriticalSection(CRITICAL_SECTION* lock) { pthread_mutex_unlock(lock); }
+
+/*--------------------------------------------------------------------------------------------*/
+// threads - a thread handle must be either waited on or closed, as with the Win32 API
+HANDLE      CreateThread(void* security, size_t stackSize, LPTHREAD_START_ROUTINE start, LPVOID param, DWORD flags, DWORD* threadID);
+DWORD       WaitForSingleObject(HANDLE handle, DWORD milliseconds);
+DWORD       WaitForMultipleObjects(DWORD count, const HANDLE* handles, BOOL waitAll, DWORD milliseconds);
+BOOL        CloseHandle(HANDLE handle);
+DWORD       GetCurrentThreadId();
+inline DWORD GetCurrentProcessId() { return (DWORD)getpid(); }
+inline DWORD GetLastError() { return (DWORD)errno; }
+inline void Sleep(DWORD milliseconds) { usleep(milliseconds * 1000); }
+inline void GetSystemInfo(SYSTEM_INFO* info) { info->dwNumberOfProcessors = (DWORD)sysconf(_SC_NPROCESSORS_ONLN); }
+
+// code patching & windowing are never exercised by the tests
+inline BOOL VirtualProtect(void*, size_t, DWORD, DWORD*) { return FALSE; }
+inline BOOL FlushInstructionCache(HANDLE, const void*, size_t) { return TRUE; }
+inline HANDLE GetCurrentProcess() { return 0; }
+inline UINT_PTR SetTimer(HWND, UINT_PTR, UINT, TIMERPROC) { return 1; }
+inline BOOL KillTimer(HWND, UINT_PTR) { return TRUE; }
+
+// files & settings
+inline BOOL MoveFileEx(const char* from, const char* to, DWORD) { return rename(from,to) == 0; }
+inline UINT GetPrivateProfileInt(const char*, const char*, int defaultValue, const char*) { return (UINT)defaultValue; }
+
+/*--------------------------------------------------------------------------------------------*/
+// MSVC CRT
+#define _TRUNCATE   ((size_t)-1)
+#define sprintf_s   snprintf
+#define _stricmp    strcasecmp
+#define _strdup     strdup
+#define strtok_s    strtok_r
+inline int fopen_s(FILE** file, const char* path, const char* mode) { *file = fopen(path,mode); return *file ? 0 : errno; }
+inline FILE* _fsopen(const char* path, const char* mode, int) { return fopen(path,mode); }   // share flags from share.h
+inline int strcpy_s(char* dest, size_t size, const char* source)
+{
+    if (strlen(source) >= size) { if (size) dest[0] = 0; return ERANGE; }
+    strcpy(dest,source);
+    return 0;
+}
+inline int strncpy_s(char* dest, size_t size, const char* source, size_t count)
+{
+    size_t length = strnlen(source,count == _TRUNCATE ? size - 1 : count);
+    if (length >= size) length = size - 1;
+    memcpy(dest,source,length);
+    dest[length] = 0;
+    return 0;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// COEF output log
+// Channels are ordered Fatal, Error, Warning, Message, Verbose, Debug.  Lines are formatted once and
+// passed to every attached target; with no targets attached, errors & warnings go to stderr and all
+// other channels are discarded without formatting.
+struct OutputStyle
+{
+    bool    includeTime;
+    bool    includeSource;
+    OutputStyle() : includeTime(true), includeSource(true) {}
+};
+class OutputTarget
+{
+public:
+    virtual void    WriteOutputLine(const OutputStyle& style, time_t time, int channel, const char* source, const char* text) = 0;
+    void            LoadRulesFromINI(const char*, const char*) {}
+    virtual         ~OutputTarget() {}
+    OutputStyle     style;
+};
+class BufferTarget : public OutputTarget
+{
+public:
+    virtual void    WriteOutputLine(const OutputStyle& style, time_t time, int channel, const char* source, const char* text);
+    const char*     LastOutputLine() { return line; }
+    BufferTarget() { line[0] = 0; }
+private:
+    char            line[0x400];
+};
+class OutputLog
+{
+public:
+    void            Output(int channel, const char* format, ...) __attribute__((format(printf,3,4)));
+    void            AttachTarget(OutputTarget& target);
+    void            DetachTarget(OutputTarget& target);
+    void            Indent() { indent++; }
+    void            Outdent() { if (indent) indent--; }
+    void            PushStyle() {}
+    void            PopStyle() {}
+    OutputLog() : targetCount(0), indent(0) {}
+private:
+    OutputTarget*   targets[8];
+    UInt32          targetCount;
+    UInt32          indent;
+};
+extern OutputLog& gLog;
+
+#define _FATALERROR(...)    gLog.Output(0,__VA_ARGS__)
+#define _ERROR(...)         gLog.Output(1,__VA_ARGS__)
+#define _WARNING(...)       gLog.Output(2,__VA_ARGS__)
+#define _MESSAGE(...)       gLog.Output(3,__VA_ARGS__)
+#define _VMESSAGE(...)      gLog.Output(4,__VA_ARGS__)
+#define _DMESSAGE(...)      gLog.Output(5,__VA_ARGS__)
@@ -0,0 +1,69 @@
+/*
+    Stand-in Win32 threads, for the Linux test & benchmark build
+    See Prefix.h
+*/
+#include <sys/syscall.h>
+
+/*--------------------------------------------------------------------------------------------*/
+// A thread handle owns the pthread until it is joined by a wait or detached by CloseHandle().
+// The start routine & parameter are passed separately, so a detached thread never touches its handle.
+struct ThreadHandle
+{
+    pthread_t   thread;
+    bool        joined;
+};
+struct ThreadStart
+{
+    LPTHREAD_START_ROUTINE  start;
+    LPVOID                  param;
+};
+static void* ThreadEntry(void* param)
+{
+    ThreadStart start = *(ThreadStart*)param;
+    delete (ThreadStart*)param;
+    start.start(start.param);
+    return 0;
+}
+
+HANDLE CreateThread(void* security, size_t stackSize, LPTHREAD_START_ROUTINE start, LPVOID param, DWORD flags, DWORD* threadID)
+{
+    ThreadStart* entry = new ThreadStart;
+    entry->start = start;
+    entry->param = param;
+    ThreadHandle* handle = new ThreadHandle;
+    handle->joined = false;
+    if (pthread_create(&handle->thread,0,&ThreadEntry,entry) != 0)
+    {
+        delete entry;
+        delete handle;
+        return 0;
+    }
+    if (threadID) *threadID = 0; // not used by the plugin
+    return handle;
+}
+DWORD WaitForSingleObject(HANDLE handle, DWORD milliseconds)
+{
+    // only infinite waits on threads are supported
+    ThreadHandle* thread = (ThreadHandle*)handle;
+    if (!thread->joined) pthread_join(thread->thread,0);
+    thread->joined = true;
+    return 0; // WAIT_OBJECT_0
+}
+DWORD WaitForMultipleObjects(DWORD count, const HANDLE* handles, BOOL waitAll, DWORD milliseconds)
+{
+    // only infinite waits for all threads are supported
+    for (DWORD i = 0; i < count; i++) WaitForSingleObject(handles[i],milliseconds);
+    return 0;
+}
+BOOL CloseHandle(HANDLE handle)
+{
+    ThreadHandle* thread = (ThreadHandle*)handle;
+    if (!thread) return FALSE;
+    if (!thread->joined) pthread_detach(thread->thread);
+    delete thread;
+    return TRUE;
+}
+DWORD GetCurrentThreadId()
+{
+    return (DWORD)syscall(SYS_gettid);
+}
@@ -0,0 +1,25 @@
+/*
+    Stand-in for the OBSE plugin API
+
+    Only the serialization interface is declared in full, since the tests drive the cosave code through it;
+    the other interfaces are only referenced by pointer.  The function pointer layout of the real interface
+    is not reproduced.
+*/
+#pragma once
+
+typedef UInt32  PluginHandle;
+
+struct  OBSEInterface;
+struct  OBSEArrayVarInterface;
+struct  OBSEStringVarInterface;
+struct  OBSEScriptInterface;
+struct  OBSECommandTableInterface;
+
+struct OBSESerializationInterface
+{
+    bool    (* OpenRecord)(UInt32 type, UInt32 version);
+    bool    (* WriteRecordData)(const void* buf, UInt32 length);
+    bool    (* GetNextRecordInfo)(UInt32* type, UInt32* version, UInt32* length);
+    UInt32  (* ReadRecordData)(void* buf, UInt32 length);
+    bool    (* ResolveRefID)(UInt32 refID, UInt32* outRefID);
+};
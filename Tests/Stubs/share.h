@@ -0,0 +1,9 @@
+/*
+    Stand-in for the MSVC CRT's share.h: file sharing flags for _fsopen, which ignores them (see Prefix.h)
+*/
+#pragma once
+
+#define _SH_DENYRW  0x10
+#define _SH_DENYWR  0x20
+#define _SH_DENYRD  0x30
+#define _SH_DENYNO  0x40
@@ -0,0 +1,114 @@
+/*
+    Shared harness for the Linux tests & benchmarks
+    Also defines the plugin globals normally defined by the loader & Submodule.cpp, which are not built here.
+*/
+#include "TestHarness.h"
+#include "Submodule/Interface.h"
+#include "API/TESFiles/TESFile.h"
+#include "Submodule/Trace.h"
+#include "Submodule/CSE_Interface.h"
+#include "obse/PluginAPI.h"
+
+/*--------------------------------------------------------------------------------------------*/
+// plugin globals
+OutputLog                   _gLog;
+OutputLog&                  gLog = _gLog;
+OutputTarget*               _gLogFile = 0;
+TraceRecorder               _gTrace;
+TraceRecorder&              gTrace = _gTrace;
+HMODULE                     hModule = 0;
+SubmoduleInterface          g_submoduleIntfc;
+SubmoduleInterface*         g_submoduleInfc = 0;
+const SubmoduleCommandTable* g_submoduleCmds = 0;
+OBSESerializationInterface* g_serializationIntfc = 0;
+CSEConsoleInterface*        g_cseConsoleInfc = 0;
+
+// the vtbl is aliased to this symbol by the MSVC linker; it is never patched here, since RegisterAll() is not called
+extern "C" const UInt32 MyForm_vtbl[1] = {0};
+
+/*--------------------------------------------------------------------------------------------*/
+// checks
+static UInt32 s_checks = 0;
+static UInt32 s_failures = 0;
+
+bool Test_Check(bool passed, const char* condition, const char* file, int line)
+{
+    s_checks++;
+    if (passed) return true;
+    s_failures++;
+    fprintf(stderr,"%s(%i): CHECK failed: %s\n",file,line,condition);
+    return false;
+}
+int Test_Result(const char* name)
+{
+    printf("%s: %u checks, %u failed\n",name,s_checks,s_failures);
+    return s_failures ? 1 : 0;
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// benchmarks
+UInt32 Test_Count(int argc, char* argv[], UInt32 defaultCount)
+{
+    UInt32 count = (argc > 1) ? strtoul(argv[1],0,0) : 0;
+    return count ? count : defaultCount;
+}
+void Test_Bench(const char* name, UInt64 count, const char* unit, UInt64 ticks)
+{
+    double ms = PerfTicksToMS(ticks);
+    printf("%-40s %10llu %s in %9.3f ms, %14.0f %s/s, %9.1f ns/%s\n",name,(unsigned long long)count,unit,ms,
+        ms > 0 ? count * 1000.0 / ms : 0.0,unit,count ? ms * 1000000.0 / count : 0.0,unit);
+}
+
+/*--------------------------------------------------------------------------------------------*/
+// stand-in plugin
+void Test_Initialize()
+{
+    static bool initialized = false;
+    if (initialized) return;
+    MyForm::extendedForm.Register(MYFORM_SHORTNAME);
+    MyForm::InitializeMyForm();
+    g_submoduleIntfc.Description();
+    g_submoduleInfc = &g_submoduleIntfc;
+    g_submoduleCmds = g_submoduleIntfc.CommandTable();
+    initialized = true;
+}
+std::vector<UInt8> Test_MyFormRecord(UInt32 formID, const char* editorID, UInt32 extraData)
+{
+    // record header, followed by EDID (if any) & DATA chunks
+    UInt32 header[5] = { 0, 0, 0, formID, 0 };
+    memcpy(&header[0],MYFORM_SHORTNAME,4);
+    std::vector<UInt8> record((UInt8*)header,(UInt8*)header + sizeof(header));
+    if (editorID)
+    {
+        UInt16 length = strlen(editorID) + 1;
+        record.insert(record.end(),(const UInt8*)"EDID",(const UInt8*)"EDID" + 4);
+        record.insert(record.end(),(UInt8*)&length,(UInt8*)&length + 2);
+        record.insert(record.end(),(const UInt8*)editorID,(const UInt8*)editorID + length);
+    }
+    UInt32 data[3] = { 0, 0, extraData };
+    UInt16 length = sizeof(data);
+    record.insert(record.end(),(const UInt8*)"DATA",(const UInt8*)"DATA" + 4);
+    record.insert(record.end(),(UInt8*)&length,(UInt8*)&length + 2);
+    record.insert(record.end(),(UInt8*)data,(UInt8*)data + sizeof(data));
+    UInt32 dataSize = record.size() - sizeof(header);
+    memcpy(&record[4],&dataSize,4);
+    return record;
+}
+MyForm* Test_CreateMyForm(UInt32 formID, const char* editorID)
+{
+    // constructed & loaded by the engine, then added to the data handler
+    MyForm* form = (MyForm*)MyForm::CreateMyForm();
+    std::vector<UInt8> record = Test_MyFormRecord(formID,editorID);
+    TESFile file("Test.esp",&record[0],record.size());
+    form->LoadForm(file);
+    MyForm::extendedForm.AddToFormList(form);
+    return form;
+}
+void Test_DestroyMyForms()
+{
+    BSSimpleList<TESForm*>& list = MyForm::extendedForm.FormList();
+    std::vector<TESForm*> forms;
+    for (BSSimpleList<TESForm*>::Node* node = &list.firstNode; node && node->data; node = node->next) forms.push_back(node->data);
+    MyForm::extendedForm.ClearFormList();
+    for (UInt32 i = 0; i < forms.size(); i++) delete forms[i];
+}
@@ -0,0 +1,30 @@
+/*
+    Shared harness for the Linux tests & benchmarks
+
+    Each test or benchmark is a separate executable, built against the plugin sources and the stand-in
+    COEF/OBSE/Win32 layer in Tests/Stubs (see Stubs/Prefix.h), and registered with CTest.  A test fails
+    if any CHECK fails; a benchmark reports its throughput and fails only if its own checks fail.
+    Benchmarks take an optional item count as their first argument, so they can be run at full scale
+    by hand while staying quick under CTest.
+*/
+#pragma once
+
+#include "Submodule/MyForm.h"
+#include "Submodule/Timing.h"
+
+#include <vector>
+
+// checks
+#define CHECK(condition) Test_Check((condition),#condition,__FILE__,__LINE__)
+bool            Test_Check(bool passed, const char* condition, const char* file, int line);
+int             Test_Result(const char* name);  // prints a summary, returns the process exit code
+
+// benchmarks
+UInt32          Test_Count(int argc, char* argv[], UInt32 defaultCount);   // item count from the command line
+void            Test_Bench(const char* name, UInt64 count, const char* unit, UInt64 ticks); // prints throughput
+
+// stand-in plugin
+void            Test_Initialize();  // registers MyForm & attaches the submodule to the loader globals
+std::vector<UInt8> Test_MyFormRecord(UInt32 formID, const char* editorID = 0, UInt32 extraData = 0); // builds a MyForm record
+MyForm*         Test_CreateMyForm(UInt32 formID, const char* editorID = 0); // creates & loads a MyForm, and adds it to the form list
+void            Test_DestroyMyForms();  // destroys all MyForms in the form list
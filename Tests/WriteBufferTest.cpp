@@ -0,0 +1,56 @@
+/*
+    Write buffer staging, coalescing & tracing
+*/
+#include "TestHarness.h"
+#include "Submodule/WriteBuffer.h"
+#include "Submodule/Interface.h"
+
+// local declarations of globals defined in the test harness & interface.cpp
+extern SubmoduleInterface* g_submoduleInfc;
+extern const SubmoduleCommandTable* g_submoduleCmds;
+extern bool g_traceCommands;
+
+int main(int argc, char* argv[])
+{
+    Test_Initialize();
+    MyForm* form = Test_CreateMyForm(0x01000800);
+    MyForm* other = Test_CreateMyForm(0x01000801);
+
+    // disabled by default: writes are applied immediately
+    CHECK(!g_extraDataWrites.enabled);
+    g_submoduleCmds->SetMyFormExtraData(form,5);
+    CHECK(form->extraData == 5 && g_extraDataWrites.Count() == 0);
+
+    // enabled: writes are staged & coalesced until committed
+    g_extraDataWrites.enabled = true;
+    g_submoduleCmds->SetMyFormExtraData(form,6);
+    g_submoduleCmds->SetMyFormExtraData(form,7);
+    g_submoduleCmds->SetMyFormExtraData(other,8);
+    CHECK(form->extraData == 5 && g_extraDataWrites.Count() == 2);
+    CHECK(g_submoduleCmds->GetMyFormExtraData(form) == 7);  // read your writes
+    g_extraDataWrites.readYourWrites = false;
+    CHECK(g_submoduleCmds->GetMyFormExtraData(form) == 5);
+    CHECK(g_extraDataWrites.Latest(form) == 7);
+    g_extraDataWrites.readYourWrites = true;
+
+    // the trace shows the previous staged value, not the committed one
+    BufferTarget target;
+    gLog.AttachTarget(target);
+    g_traceCommands = true;
+    g_submoduleCmds->SetMyFormExtraData(form,9);
+    CHECK(strstr(target.LastOutputLine(),"SetMyFormExtraData ( 01000800, 7 -> 9 )") != 0);
+    g_submoduleInfc->SetMyFormExtraData(form,10);
+    CHECK(strstr(target.LastOutputLine(),"SetMyFormExtraData ( 01000800, 9 -> 10 )") != 0);
+    g_traceCommands = false;
+    gLog.DetachTarget(target);
+
+    // commit applies the last write to each form; discarded writes are dropped
+    g_extraDataWrites.Discard(other);
+    CHECK(g_extraDataWrites.Commit() == 1);
+    CHECK(form->extraData == 10 && other->extraData == 0);
+    CHECK(g_extraDataWrites.Count() == 0);
+
+    g_extraDataWrites.enabled = false;
+    Test_DestroyMyForms();
+    return Test_Result("WriteBufferTest");
+}